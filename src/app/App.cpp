@@ -3,6 +3,8 @@
 #include <algorithm>
 #include <cmath>
 #include <src/utility/TextureUtils.h>
+#include "GpuMeshSink.h"
+#include <src/voxel/BlockCursor.h>
 
 bool App::InitWindow()
 {
@@ -63,12 +65,17 @@ bool App::InitGL()
 bool App::LoadAssets()
 {
     voxelShader_ = std::make_unique<Shader>("voxel.vs", "voxel.fs");
-    oceanShader_ = std::make_unique<Shader>("voxel.vs", "ocean.fs");
+    oceanShader_ = std::make_unique<Shader>("ocean.vs", "ocean.fs");
     world_.planet.baseRadius = 4096.f;
     world_.planet.maxHeight = 12.0f;
     world_.planet.noiseFreq = 3.0f;
     world_.planet.octaves = 5;
     world_.planet.seaLevelOffset = -2.0f;
+    auto sink = std::make_unique<GpuMeshSink>();
+    gpuSink_ = sink.get();
+    world_.SetMeshSink(std::move(sink));
+    world_.SetTargetFrameTime(targetFrameUs_);
+    world_.OpenRegionStore("saves/planet");
 
     blockTexArray_ = util::LoadTexture2DArray({
         "assets/textures/voxel_cube_grass.png",
@@ -100,6 +107,7 @@ int App::Run()
     camera_.Position = glm::vec3(0.0f, 0.0f, world_.planet.baseRadius + 20.0f);
     SnapCameraToSurface(spawnAboveSea_);
     InitPlayerFromCamera();
+    lastCamPos_ = camera_.Position;
 
 
     glClearColor(.16f, .46f, 96.f, 1.0f);
@@ -122,11 +130,16 @@ int App::Run()
 
         camera_.SetWorldUp(glm::normalize(camera_.Position));
 
-        world_.UpdateStreaming(camera_.Position, camera_.Front);
+        // velocity for the streaming look-ahead (World caps how far it reaches)
+        glm::vec3 camVel(0.0f);
+        if (deltaTime_ > 0.0f) camVel = (camera_.Position - lastCamPos_) / deltaTime_;
+        lastCamPos_ = camera_.Position;
+
+        world_.UpdateStreaming(camera_.Position, camera_.Front, camVel);
 
         if (loading_)
         {
-            world_.TickBuildQueues(loadGenPerFrame_, loadMeshPerFrame_);
+            world_.TickBuildQueues(loadBudgetUs_);
 
             World::StreamStats st = world_.GetStreamStats();
             float p = (st.target > 0) ? (float(st.meshed) / float(st.target)) : 1.0f;
@@ -144,6 +157,7 @@ int App::Run()
             glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
             glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
             glfwSwapBuffers(window_);
+            world_.GetMeshSink().EndFrame();
             glfwPollEvents();
 
             if (world_.IsStreamReady())
@@ -155,8 +169,20 @@ int App::Run()
 
             continue; // IMPORTANT: skip normal rendering until ready
         }
-        world_.TickBuildQueues(playGenPerFrame_, playMeshPerFrame_);
-        //world_.TickBuildQueues(2,4);
+        world_.TickBuildQueues(playBudgetUs_, deltaTime_ * 1e6);
+
+        double statsT = glfwGetTime();
+        if (gpuSink_ && statsT - statsTitleT0_ > 0.5)
+        {
+            // deferred frees still count as used until their frames retire
+            ArenaAllocator::Stats as = gpuSink_->GetArenaStats();
+            const double mib = sizeof(PackedQuad) / (1024.0 * 1024.0);
+            char title[256];
+            std::snprintf(title, sizeof(title), "VoxelPlanet [mesh arena %.1f/%.1f MiB, %u free blocks, frag %.0f%%]",
+                as.used * mib, as.capacity * mib, as.freeBlocks, as.Fragmentation() * 100.0f);
+            glfwSetWindowTitle(window_, title);
+            statsTitleT0_ = statsT;
+        }
 
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -221,6 +247,7 @@ int App::Run()
         voxelShader_->setFloat("uFogStart", fogStart);
         voxelShader_->setFloat("uFogEnd", fogEnd);
 
+        world_.SetViewFrustum(projection * view);
         world_.DrawOpaque();
 
         
@@ -298,9 +325,15 @@ int App::Run()
 
 
         glfwSwapBuffers(window_);
+        world_.GetMeshSink().EndFrame();
         glfwPollEvents();
     }
 
+    // free chunk meshes while the context is still alive
+    world_.SetMeshSink(nullptr);
+    gpuSink_ = nullptr;
+    world_.FlushRegionStore();
+
     glfwTerminate();
     return 0;
 }
@@ -566,6 +599,9 @@ void App::ResolveHorizontalCollisions(glm::vec3& feetPos, const glm::vec3& up)
     const float usable = std::max(0.0f, playerHeight_ - 2.0f * r);
     const int samples = std::max(3, (int)std::ceil(usable / 0.50f) + 1); // sample every ~0.5 voxel
 
+    // the spheres overlap a handful of voxels in one or two chunks
+    BlockCursor blocks(world_);
+
     auto solveSphere = [&](glm::vec3& center) -> bool
     {
         bool hit = false;
@@ -584,7 +620,7 @@ void App::ResolveHorizontalCollisions(glm::vec3& feetPos, const glm::vec3& up)
             for (int y = minY; y <= maxY; ++y)
                 for (int x = minX; x <= maxX; ++x)
                 {
-                    Block b = world_.GetBlock(x, y, z);
+                    Block b = blocks.At(x, y, z);
                     if (!IsCollidableBlock(b)) continue;
 
                     glm::vec3 bmin((float)x, (float)y, (float)z);
@@ -668,6 +704,9 @@ void App::ResolveVerticalCollisions(glm::vec3& feetPos, const glm::vec3& up, flo
 
     onGround = false;
 
+    // the spheres overlap a handful of voxels in one or two chunks
+    BlockCursor blocks(world_);
+
     auto solveSphere = [&](glm::vec3& center) -> bool
     {
         bool hit = false;
@@ -686,7 +725,7 @@ void App::ResolveVerticalCollisions(glm::vec3& feetPos, const glm::vec3& up, flo
             for (int y = minY; y <= maxY; ++y)
                 for (int x = minX; x <= maxX; ++x)
                 {
-                    Block b = world_.GetBlock(x, y, z);
+                    Block b = blocks.At(x, y, z);
                     if (!IsCollidableBlock(b)) continue;
 
                     glm::vec3 bmin((float)x, (float)y, (float)z);
@@ -41,12 +41,16 @@ private:
     // Startup loading screen
     bool loading_ = true;
     double loadingTitleT0_ = 0.0;
+    double statsTitleT0_ = 0.0;          // play mode: mesh arena stats in the title
 
-    // Streaming budgets: tune per machine
-    int loadGenPerFrame_ = 2;
-    int loadMeshPerFrame_ = 4;
-    int playGenPerFrame_ = 1;
-    int playMeshPerFrame_ = 3;
+    class GpuMeshSink* gpuSink_ = nullptr; // owned by world_
+
+    // Main-thread build time per frame (World::TickBuildQueues). The loading
+    // screen draws nothing, so it can spend most of a frame building.
+    double loadBudgetUs_ = 24000.0;
+    double playBudgetUs_ = 3000.0;
+    double targetFrameUs_ = 1e6 / 60.0; // over this, the play budget shrinks
+    glm::vec3 lastCamPos_{ 0.0f };      // last frame's, for the streaming look-ahead
 
     GLFWwindow* window_ = nullptr;
     int width_ = INIT_W;
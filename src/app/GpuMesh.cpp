@@ -1,4 +1,5 @@
 #include "GpuMesh.h"
+#include <algorithm>
 #include <cstddef> // offsetof
 #include <../mesh/VoxelVertex.h>
 
@@ -58,4 +59,77 @@ void GpuMesh::Destroy()
     if (vbo) { glDeleteBuffers(1, &vbo); vbo = 0; }
     if (vao) { glDeleteVertexArrays(1, &vao); vao = 0; }
     count = 0;
-}
\ No newline at end of file
+}
+
+GpuQuadArena::GpuQuadArena(uint32_t initialQuads)
+    : initialQuads_(initialQuads)
+{
+}
+
+void GpuQuadArena::GrowBuffer(uint32_t minQuads)
+{
+    uint32_t oldCap = alloc_.Capacity();
+    uint32_t newCap = std::max(oldCap ? oldCap * 2 : initialQuads_, oldCap + minQuads);
+
+    GLuint grown = 0;
+    glGenBuffers(1, &grown);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, grown);
+    glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)newCap * sizeof(PackedQuad), nullptr, GL_DYNAMIC_DRAW);
+
+    if (ssbo_) {
+        glBindBuffer(GL_COPY_READ_BUFFER, ssbo_);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0,
+            (GLsizeiptr)oldCap * sizeof(PackedQuad));
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        glDeleteBuffers(1, &ssbo_);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    ssbo_ = grown;
+    alloc_.Grow(newCap);
+}
+
+GpuQuadArena::Range GpuQuadArena::Upload(const std::vector<PackedQuad>& quads)
+{
+    Range r;
+    if (quads.empty()) return r;
+
+    uint32_t n = (uint32_t)quads.size();
+    r.offset = alloc_.Allocate(n);
+    if (r.offset == ArenaAllocator::INVALID) {
+        GrowBuffer(n);
+        r.offset = alloc_.Allocate(n);
+    }
+    r.count = n;
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssbo_);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER,
+        (GLintptr)r.offset * sizeof(PackedQuad),
+        (GLsizeiptr)n * sizeof(PackedQuad),
+        quads.data());
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    return r;
+}
+
+void GpuQuadArena::Free(Range& r)
+{
+    if (r.count > 0)
+        pendingFrees_.push_back({ r.offset, r.count, frame_ });
+    r = {};
+}
+
+void GpuQuadArena::NextFrame()
+{
+    frame_++;
+    while (!pendingFrees_.empty() && pendingFrees_.front().frame + FRAMES_IN_FLIGHT <= frame_) {
+        alloc_.Free(pendingFrees_.front().offset, pendingFrees_.front().count);
+        pendingFrees_.pop_front();
+    }
+}
+
+void GpuQuadArena::Destroy()
+{
+    if (ssbo_) { glDeleteBuffers(1, &ssbo_); ssbo_ = 0; }
+    alloc_ = ArenaAllocator();
+    pendingFrees_.clear();
+}
@@ -1,7 +1,10 @@
 #pragma once
+#include <deque>
 #include <vector>
 #include <glad/glad.h>
 #include "../mesh/VoxelVertex.h"
+#include "../mesh/PackedQuad.h"
+#include "../mesh/ArenaAllocator.h"
 
 struct GpuMesh {
     GLuint vao = 0;
@@ -11,4 +14,43 @@ struct GpuMesh {
     void Upload(const std::vector<VoxelVertex>& verts);
     void Draw() const;
     void Destroy();
-};
\ No newline at end of file
+};
+
+// All chunk quads live in one SSBO, sub-allocated per chunk mesh by
+// ArenaAllocator (units = quads). voxel.vs indexes it with gl_VertexID / 6,
+// so a draw of range r is first = r.offset * 6, count = r.count * 6.
+// Needs a current GL context for everything but GetStats.
+class GpuQuadArena {
+public:
+    struct Range {
+        uint32_t offset = ArenaAllocator::INVALID;
+        uint32_t count = 0; // quads
+    };
+
+    // Frees wait this many frames before the range can be handed out again,
+    // so a remesh never overwrites quads the GPU may still be drawing from.
+    static constexpr uint64_t FRAMES_IN_FLIGHT = 3;
+
+    explicit GpuQuadArena(uint32_t initialQuads = 1u << 20); // 8 MiB
+
+    // empty quads -> empty range, no allocation
+    Range Upload(const std::vector<PackedQuad>& quads);
+    void Free(Range& r); // deferred, resets r
+    void NextFrame();    // retires frees older than FRAMES_IN_FLIGHT
+
+    GLuint Buffer() const { return ssbo_; }
+    ArenaAllocator::Stats GetStats() const { return alloc_.GetStats(); }
+
+    void Destroy();
+
+private:
+    void GrowBuffer(uint32_t minQuads);
+
+    struct PendingFree { uint32_t offset, count; uint64_t frame; };
+
+    GLuint ssbo_ = 0;
+    uint32_t initialQuads_;
+    ArenaAllocator alloc_;
+    std::deque<PendingFree> pendingFrees_;
+    uint64_t frame_ = 0;
+};
@@ -0,0 +1,107 @@
+#include "GpuMeshSink.h"
+#include <../mesh/ChunkMesher.h>
+
+GpuMeshSink::~GpuMeshSink()
+{
+    arena_.Destroy();
+    if (vao_) glDeleteVertexArrays(1, &vao_);
+    if (originBuf_) glDeleteBuffers(1, &originBuf_);
+    if (indirectBuf_) glDeleteBuffers(1, &indirectBuf_);
+}
+
+void GpuMeshSink::Upload(ChunkMeshSlot& slot, ChunkMeshData& mesh)
+{
+    if (slot.id == 0) {
+        if (!freeIds_.empty()) {
+            slot.id = freeIds_.back();
+            freeIds_.pop_back();
+        }
+        else {
+            meshes_.emplace_back();
+            slot.id = (uint32_t)meshes_.size();
+        }
+    }
+
+    // remesh: the old ranges stay valid for frames already in flight
+    Entry& e = meshes_[slot.id - 1];
+    arena_.Free(e.opaque);
+    arena_.Free(e.water);
+    e.opaque = arena_.Upload(mesh.opaque);
+    e.water = arena_.Upload(mesh.water);
+    e.origin = mesh.origin;
+
+    slot.opaqueCount = (int)e.opaque.count;
+    slot.waterCount = (int)e.water.count;
+}
+
+void GpuMeshSink::Release(ChunkMeshSlot& slot)
+{
+    if (slot.id != 0) {
+        Entry& e = meshes_[slot.id - 1];
+        arena_.Free(e.opaque);
+        arena_.Free(e.water);
+        freeIds_.push_back(slot.id);
+    }
+    slot = {};
+}
+
+void GpuMeshSink::CreateDrawObjects() const
+{
+    glGenVertexArrays(1, &vao_);
+    glGenBuffers(1, &originBuf_);
+    glGenBuffers(1, &indirectBuf_);
+
+    // location 0 = aChunkOrigin, one value per instance; every command draws
+    // one instance starting at baseInstance, so that selects its origin
+    glBindVertexArray(vao_);
+    glBindBuffer(GL_ARRAY_BUFFER, originBuf_);
+    glEnableVertexAttribArray(0);
+    glVertexAttribIPointer(0, 3, GL_INT, sizeof(glm::ivec4), (void*)0);
+    glVertexAttribDivisor(0, 1);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void GpuMeshSink::BeginPass(MeshPass) const
+{
+    commands_.clear();
+    origins_.clear();
+}
+
+void GpuMeshSink::Draw(const ChunkMeshSlot& slot, MeshPass pass) const
+{
+    if (slot.id == 0) return;
+    const Entry& e = meshes_[slot.id - 1];
+    const GpuQuadArena::Range& r = (pass == MeshPass::Opaque) ? e.opaque : e.water;
+    if (r.count == 0) return;
+
+    commands_.push_back({ r.count * 6, 1, r.offset * 6, (GLuint)origins_.size() });
+    origins_.push_back(glm::ivec4(e.origin, 0));
+}
+
+void GpuMeshSink::EndPass() const
+{
+    if (commands_.empty()) return;
+    if (vao_ == 0) CreateDrawObjects();
+
+    // orphan + refill; commands keep Draw order (water relies on it)
+    glBindBuffer(GL_ARRAY_BUFFER, originBuf_);
+    glBufferData(GL_ARRAY_BUFFER, origins_.size() * sizeof(glm::ivec4), origins_.data(), GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuf_);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, commands_.size() * sizeof(DrawCommand), commands_.data(), GL_STREAM_DRAW);
+
+    glBindVertexArray(vao_);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, arena_.Buffer());
+    glMultiDrawArraysIndirect(GL_TRIANGLES, nullptr, (GLsizei)commands_.size(), 0);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    glBindVertexArray(0);
+}
+
+void GpuMeshSink::EndFrame()
+{
+    arena_.NextFrame();
+}
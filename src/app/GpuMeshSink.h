@@ -0,0 +1,45 @@
+#pragma once
+#include <vector>
+#include <glm.hpp>
+#include <../voxel/MeshSink.h>
+#include "GpuMesh.h"
+
+// Default sink for the windowed app. Every chunk mesh is a range in one
+// shared GpuQuadArena; a pass collects one indirect command per visible
+// chunk and submits them all with a single glMultiDrawArraysIndirect at
+// EndPass. Needs a current GL context for Upload/Release/Draw, and the
+// chunk shader (voxel.vs) bound when a pass ends.
+class GpuMeshSink : public MeshSink {
+public:
+    ~GpuMeshSink() override;
+
+    void Upload(ChunkMeshSlot& slot, ChunkMeshData& mesh) override;
+    void Release(ChunkMeshSlot& slot) override;
+
+    void BeginPass(MeshPass pass) const override;
+    void Draw(const ChunkMeshSlot& slot, MeshPass pass) const override;
+    void EndPass() const override;
+    void EndFrame() override;
+
+    ArenaAllocator::Stats GetArenaStats() const { return arena_.GetStats(); }
+
+private:
+    struct Entry { GpuQuadArena::Range opaque; GpuQuadArena::Range water; glm::ivec3 origin{ 0 }; };
+    std::vector<Entry> meshes_;  // index = id - 1
+    std::vector<uint32_t> freeIds_;
+
+    GpuQuadArena arena_;
+
+    // layout fixed by glMultiDrawArraysIndirect
+    struct DrawCommand { GLuint count, instanceCount, first, baseInstance; };
+
+    // per pass, rebuilt every BeginPass; baseInstance = index into origins_,
+    // fed to voxel.vs as a per-instance attribute
+    mutable std::vector<DrawCommand> commands_;
+    mutable std::vector<glm::ivec4> origins_;
+
+    void CreateDrawObjects() const;
+    mutable GLuint vao_ = 0;
+    mutable GLuint originBuf_ = 0;
+    mutable GLuint indirectBuf_ = 0;
+};
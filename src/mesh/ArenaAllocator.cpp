@@ -0,0 +1,103 @@
+#include "ArenaAllocator.h"
+#include <cassert>
+#include <iterator>
+
+ArenaAllocator::ArenaAllocator(uint32_t capacity)
+{
+    Grow(capacity);
+}
+
+void ArenaAllocator::InsertFree(uint32_t offset, uint32_t size)
+{
+    byOffset_.emplace(offset, size);
+    bySize_.emplace(size, offset);
+}
+
+void ArenaAllocator::EraseFree(std::map<uint32_t, uint32_t>::iterator it)
+{
+    auto range = bySize_.equal_range(it->second);
+    for (auto s = range.first; s != range.second; ++s) {
+        if (s->second == it->first) {
+            bySize_.erase(s);
+            break;
+        }
+    }
+    byOffset_.erase(it);
+}
+
+uint32_t ArenaAllocator::Allocate(uint32_t size)
+{
+    if (size == 0) return INVALID;
+
+    auto best = bySize_.lower_bound(size);
+    if (best == bySize_.end()) return INVALID;
+
+    uint32_t offset = best->second;
+    uint32_t blockSize = best->first;
+    EraseFree(byOffset_.find(offset));
+
+    if (blockSize > size)
+        InsertFree(offset + size, blockSize - size);
+
+    used_ += size;
+    allocations_++;
+    return offset;
+}
+
+void ArenaAllocator::Free(uint32_t offset, uint32_t size)
+{
+    if (size == 0 || offset == INVALID) return;
+    assert(offset + size <= capacity_);
+    assert(used_ >= size && allocations_ > 0);
+
+    used_ -= size;
+    allocations_--;
+
+    // merge with the free block right after ...
+    auto next = byOffset_.lower_bound(offset);
+    assert(next == byOffset_.end() || next->first >= offset + size); // double free / overlap
+    if (next != byOffset_.end() && next->first == offset + size) {
+        size += next->second;
+        EraseFree(next);
+    }
+
+    // ... and the one right before
+    auto after = byOffset_.lower_bound(offset);
+    if (after != byOffset_.begin()) {
+        auto prev = std::prev(after);
+        assert(prev->first + prev->second <= offset);
+        if (prev->first + prev->second == offset) {
+            offset = prev->first;
+            size += prev->second;
+            EraseFree(prev);
+        }
+    }
+
+    InsertFree(offset, size);
+}
+
+void ArenaAllocator::Grow(uint32_t newCapacity)
+{
+    if (newCapacity <= capacity_) return;
+
+    uint32_t oldCapacity = capacity_;
+    capacity_ = newCapacity;
+
+    // new tail counts as one allocation being returned, so it merges with a
+    // free block that already ends at the old capacity
+    used_ += newCapacity - oldCapacity;
+    allocations_++;
+    Free(oldCapacity, newCapacity - oldCapacity);
+}
+
+ArenaAllocator::Stats ArenaAllocator::GetStats() const
+{
+    Stats s;
+    s.capacity = capacity_;
+    s.used = used_;
+    s.freeTotal = capacity_ - used_;
+    s.largestFree = bySize_.empty() ? 0 : bySize_.rbegin()->first;
+    s.freeBlocks = (uint32_t)byOffset_.size();
+    s.allocations = allocations_;
+    return s;
+}
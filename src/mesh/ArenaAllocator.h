@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <map>
+
+// Offset allocator for one big buffer: hands out [offset, offset+size)
+// ranges in abstract units (the GPU sink uses quads). Best-fit over a free
+// list, neighbors coalesce on Free. No GL, no knowledge of what is stored.
+//
+// Free must be called with the size that was allocated; the owner keeps it.
+class ArenaAllocator {
+public:
+    static constexpr uint32_t INVALID = 0xFFFFFFFFu;
+
+    struct Stats {
+        uint32_t capacity = 0;
+        uint32_t used = 0;
+        uint32_t freeTotal = 0;
+        uint32_t largestFree = 0;
+        uint32_t freeBlocks = 0;
+        uint32_t allocations = 0;
+
+        // 0 = all free space in one block, -> 1 = free space in crumbs
+        float Fragmentation() const
+        {
+            return freeTotal ? 1.0f - (float)largestFree / (float)freeTotal : 0.0f;
+        }
+    };
+
+    explicit ArenaAllocator(uint32_t capacity = 0);
+
+    // offset of a free range of exactly size units, or INVALID if none fits
+    uint32_t Allocate(uint32_t size);
+    void Free(uint32_t offset, uint32_t size);
+
+    // Append space at the end; existing offsets stay valid.
+    void Grow(uint32_t newCapacity);
+
+    uint32_t Capacity() const { return capacity_; }
+    Stats GetStats() const;
+
+private:
+    void InsertFree(uint32_t offset, uint32_t size);
+    void EraseFree(std::map<uint32_t, uint32_t>::iterator it);
+
+    uint32_t capacity_ = 0;
+    uint32_t used_ = 0;
+    uint32_t allocations_ = 0;
+
+    std::map<uint32_t, uint32_t> byOffset_;     // free blocks: offset -> size
+    std::multimap<uint32_t, uint32_t> bySize_;  // same blocks: size -> offset
+};
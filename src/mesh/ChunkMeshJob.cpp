@@ -0,0 +1,74 @@
+#include "ChunkMeshJob.h"
+#include <chrono>
+
+#include "src/voxel/ChunkGen.h"
+
+// Fill the apron across faceIndex the way World::GetBlock would for a
+// neighbor that isn't generated yet.
+static void SampleFaceIntoPadded(int faceIndex, const MeshSnapshot& snap, PaddedBlocks& out)
+{
+    int axis = faceIndex >> 1;
+    int u = (axis + 1) % 3;
+    int v = (axis + 2) % 3;
+
+    glm::ivec3 chunkBase(snap.cc.x * CHUNK_SIZE, snap.cc.y * CHUNK_SIZE, snap.cc.z * CHUNK_SIZE);
+    glm::ivec3 l(0);
+    l[axis] = (faceIndex & 1) ? -1 : CHUNK_SIZE;
+
+    // the neighbor the apron belongs to decides how it's filled
+    glm::ivec3 n(snap.cc.x, snap.cc.y, snap.cc.z);
+    n[axis] += (faceIndex & 1) ? -1 : 1;
+    ChunkShell shell = ClassifyChunkShell(ChunkCoord{ n.x, n.y, n.z }, snap.pp);
+
+    for (int j = 0; j < CHUNK_SIZE; j++)
+        for (int i = 0; i < CHUNK_SIZE; i++) {
+            l[u] = i;
+            l[v] = j;
+            glm::vec3 p = glm::vec3(chunkBase + l) + glm::vec3(0.5f);
+            out[PaddedIdx(l.x, l.y, l.z)] = SampleShell(shell, p, snap.pp);
+        }
+}
+
+ChunkMeshData BuildChunkMeshFromSnapshot(const MeshSnapshot& snap)
+{
+    glm::ivec3 chunkBase(
+        snap.cc.x * CHUNK_SIZE,
+        snap.cc.y * CHUNK_SIZE,
+        snap.cc.z * CHUNK_SIZE
+    );
+
+    if (snap.facePresent == 0x3F)
+        return BuildChunkMeshWith(snap.mesher, snap.padded, chunkBase, snap.passes);
+
+    // some neighbors missing: complete the aprons on a private copy
+    auto padded = std::make_unique<PaddedBlocks>(snap.padded);
+    for (int fi = 0; fi < 6; fi++)
+        if (!(snap.facePresent & (1u << fi)))
+            SampleFaceIntoPadded(fi, snap, *padded);
+
+    return BuildChunkMeshWith(snap.mesher, *padded, chunkBase, snap.passes);
+}
+
+// --- ChunkMeshPool -----------------------------------------------------------
+
+ChunkMeshPool::ChunkMeshPool(int workers)
+    : pool_(workers, &ChunkMeshPool::Run)
+{
+}
+
+void ChunkMeshPool::Submit(std::unique_ptr<MeshSnapshot> snap, uint32_t version)
+{
+    pool_.Submit(Job{ std::move(snap), version });
+}
+
+bool ChunkMeshPool::Run(Job& job, Result& out)
+{
+    using clock = std::chrono::steady_clock;
+
+    auto t0 = clock::now();
+    out.cc = job.snap->cc;
+    out.version = job.version;
+    out.mesh = BuildChunkMeshFromSnapshot(*job.snap);
+    out.sec = std::chrono::duration<double>(clock::now() - t0).count();
+    return true;
+}
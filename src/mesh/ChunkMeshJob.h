@@ -0,0 +1,62 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "ChunkMesher.h"
+#include "src/voxel/Planet.h"
+#include "src/voxel/JobPool.h"
+
+// Everything the mesher reads for one chunk, copied on the main thread so a
+// worker can mesh without touching World. The meshers only look one voxel
+// across each face, so this is the chunk plus its six face aprons in one
+// padded volume (edge/corner apron cells are never read).
+struct MeshSnapshot {
+    ChunkCoord cc{};
+    PaddedBlocks padded{};
+
+    // bit f set = the apron across FACES[f] (0:+X 1:-X 2:+Y 3:-Y 4:+Z 5:-Z)
+    // was copied from a generated neighbor. Missing faces are sampled
+    // procedurally on the worker, same as World::GetBlock does.
+    uint8_t facePresent = 0;
+
+    // MeshPassBit set for each pass the chunk's summary says can emit quads
+    uint8_t passes = MESH_PASSES_ALL;
+
+    PlanetParams pp;
+    MesherKind mesher = MesherKind::Greedy;
+};
+
+ChunkMeshData BuildChunkMeshFromSnapshot(const MeshSnapshot& snap);
+
+// Worker threads that turn MeshSnapshots into ChunkMeshData. Each job carries
+// the chunk's mesh version at submit time so the owner can drop results that
+// were overtaken by a later edit/remesh or an unload.
+class ChunkMeshPool {
+public:
+    struct Result {
+        ChunkCoord cc{};
+        uint32_t version = 0;
+        ChunkMeshData mesh;
+        double sec = 0.0; // worker time spent meshing
+    };
+
+    explicit ChunkMeshPool(int workers);
+
+    void Submit(std::unique_ptr<MeshSnapshot> snap, uint32_t version);
+
+    size_t Drain(std::vector<std::unique_ptr<Result>>& out) { return pool_.Drain(out); }
+    size_t InFlight() const { return pool_.InFlight(); }
+    int Workers() const { return pool_.Workers(); }
+
+private:
+    struct Job {
+        std::unique_ptr<MeshSnapshot> snap;
+        uint32_t version = 0;
+    };
+
+    static bool Run(Job& job, Result& out);
+
+    JobPool<Job, Result> pool_;
+};
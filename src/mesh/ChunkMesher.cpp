@@ -1,8 +1,13 @@
 #include "ChunkMesher.h"
 #include "src/voxel/Mesher.h"
+#include "src/voxel/ChunkSummary.h"
 
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 // --- Tile selection (same logic you had in World.cpp) ------------------------
 
@@ -39,46 +44,55 @@ static inline glm::ivec2 TileForFaceOnVoxel(int faceIndex, const glm::ivec3& vox
     return SIDE_TILE[faceIndex];
 }
 
-// Use local blocks when inside the chunk; otherwise call getBlockWorld.
-static inline Block GetBlockLocalOrWorld(
-    const std::array<Block, CHUNK_SIZE* CHUNK_SIZE* CHUNK_SIZE>& blocks,
-    const glm::ivec3& chunkBase,
-    const GetBlockFn& getBlockWorld,
-    int lx, int ly, int lz)
+// --- Padded input -------------------------------------------------------------
+
+void CopyChunkIntoPadded(const BlockStorage& blocks, PaddedBlocks& out)
 {
-    if (lx >= 0 && lx < CHUNK_SIZE &&
-        ly >= 0 && ly < CHUNK_SIZE &&
-        lz >= 0 && lz < CHUNK_SIZE)
-    {
-        return blocks[Idx(lx, ly, lz)];
-    }
+    // one contiguous 16-voxel row at a time, decoded straight into place
+    for (int z = 0; z < CHUNK_SIZE; z++)
+        for (int y = 0; y < CHUNK_SIZE; y++)
+            blocks.DecodeRows(Idx(0, y, z), CHUNK_SIZE, &out[PaddedIdx(0, y, z)]);
+}
 
-    glm::ivec3 w = chunkBase + glm::ivec3(lx, ly, lz);
-    return getBlockWorld(w.x, w.y, w.z);
+void CopyNeighborFaceIntoPadded(int faceIndex, const BlockStorage& neighbor, PaddedBlocks& out)
+{
+    int axis = faceIndex >> 1;
+    int u = (axis + 1) % 3;
+    int v = (axis + 2) % 3;
+    bool positive = (faceIndex & 1) == 0;
+
+    glm::ivec3 src(0), dst(0);
+    src[axis] = positive ? 0 : CHUNK_SIZE - 1;  // neighbor's layer touching us
+    dst[axis] = positive ? CHUNK_SIZE : -1;     // where it sits in our apron
+
+    for (int j = 0; j < CHUNK_SIZE; j++)
+        for (int i = 0; i < CHUNK_SIZE; i++) {
+            src[u] = dst[u] = i;
+            src[v] = dst[v] = j;
+            out[PaddedIdx(dst.x, dst.y, dst.z)] = neighbor.Get(Idx(src.x, src.y, src.z));
+        }
 }
 
 // ----------------------------------------------------------------------------
 // 1) FACE-CULLED MESHER (this is your old BuildChunkMesh moved out cleanly)
 // ----------------------------------------------------------------------------
 ChunkMeshData BuildChunkMeshFaceCulled(
-    const std::array<Block, CHUNK_SIZE* CHUNK_SIZE* CHUNK_SIZE>& blocks,
-    const glm::ivec3& chunkBase,
-    const GetBlockFn& getBlockWorld,
-    int cubeNetW, int cubeNetH)
+    const PaddedBlocks& padded,
+    const glm::ivec3& chunkBase)
 {
     ChunkMeshData out;
-    out.opaque.reserve(CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE * 6 * 6);
-    out.water.reserve(CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE * 6 * 6);
+    out.origin = chunkBase;
+    out.opaque.reserve(CHUNK_SIZE * CHUNK_SIZE * 6);
+    out.water.reserve(CHUNK_SIZE * CHUNK_SIZE);
 
     for (int z = 0; z < CHUNK_SIZE; z++)
         for (int y = 0; y < CHUNK_SIZE; y++)
             for (int x = 0; x < CHUNK_SIZE; x++)
             {
-                Block b = blocks[Idx(x, y, z)];
+                Block b = padded[PaddedIdx(x, y, z)];
                 if (!IsSolid(b)) continue;
 
                 glm::ivec3 voxelWorld = chunkBase + glm::ivec3(x, y, z);
-                glm::vec3 base = glm::vec3(voxelWorld);
 
                 int topFi = DominantTopFaceIndex(voxelWorld);
                 int bottomFi = topFi ^ 1;
@@ -87,8 +101,7 @@ ChunkMeshData BuildChunkMeshFaceCulled(
                 {
                     const FaceDef& f = FACES[fi];
 
-                    Block nb = GetBlockLocalOrWorld(blocks, chunkBase, getBlockWorld,
-                        x + f.dir.x, y + f.dir.y, z + f.dir.z);
+                    Block nb = padded[PaddedIdx(x + f.dir.x, y + f.dir.y, z + f.dir.z)];
 
                     if (!ShouldRenderFace(b, nb)) continue;
 
@@ -97,23 +110,12 @@ ChunkMeshData BuildChunkMeshFaceCulled(
                     else if (fi == bottomFi) tile = TILE_BOTTOM;
                     else                    tile = SIDE_TILE[fi];
 
-                    glm::vec2 faceUV[4];
-                    GetCubeNetUVsTile(fi, tile.x, tile.y, cubeNetW, cubeNetH, faceUV);
-
-                    auto& verts = (b == Block::Water) ? out.water : out.opaque;
-
-                    auto push = [&](int ci) {
-                        VoxelVertex v{}; // IMPORTANT: zero-init so new fields aren't garbage
-                        v.pos = base + glm::vec3(f.c[ci]);
-                        v.localUV = UV4[ci];                              // 0..1 local face UV
-                        v.normal = f.normal;
-                        v.layer = (float)BlockLayer(b);
-                        v.tile = glm::vec2((float)tile.x, (float)tile.y); // <-- REQUIRED
-                        verts.push_back(v);
-                        };
+                    // 1x1 quad on the face's plane: +faces sit one voxel up the axis
+                    glm::ivec3 p0(x, y, z);
+                    if ((fi & 1) == 0) p0[fi >> 1] += 1;
 
-                    push(0); push(1); push(2);
-                    push(0); push(2); push(3);
+                    auto& quads = (b == Block::Water) ? out.water : out.opaque;
+                    quads.push_back(PackQuad(p0, 1, 1, fi, BlockLayer(b), tile));
                 }
             }
 
@@ -124,15 +126,6 @@ ChunkMeshData BuildChunkMeshFaceCulled(
 // 2) GREEDY MESHER (full implementation, ready when you flip the switch)
 // ----------------------------------------------------------------------------
 
-static const uint8_t FACE_Q_MAP[6][4] = {
-    {0,1,2,3}, // +X
-    {3,2,1,0}, // -X
-    {1,2,3,0}, // +Y
-    {0,3,2,1}, // -Y
-    {1,2,3,0}, // +Z
-    {0,3,2,1}, // -Z
-};
-
 static inline uint32_t MakeGreedyKey(Block b, int faceIndex, const glm::ivec2& tile)
 {
     // 0..7   block
@@ -150,21 +143,36 @@ static inline glm::ivec2 KeyTile(uint32_t key) {
     return glm::ivec2((int)((key >> 11) & 0x3u), (int)((key >> 13) & 0x3u));
 }
 
+// Emit one merged quad covering (i,j)..(i+w,j+h) in the u/v plane of `axis` at
+// slice s. Shared by the greedy and binary meshers.
+static inline void EmitGreedyQuad(
+    int axis, int s, int i, int j, int w, int h, uint32_t key,
+    std::vector<PackedQuad>& outQuads)
+{
+    glm::ivec3 p0(0);
+    p0[axis] = s;
+    p0[(axis + 1) % 3] = i;
+    p0[(axis + 2) % 3] = j;
+
+    outQuads.push_back(PackQuad(p0, w, h, KeyFace(key), BlockLayer(KeyBlock(key)), KeyTile(key)));
+}
+
 template<typename IsSolidFn>
 static void BuildGreedyPass(
-    const std::array<Block, CHUNK_SIZE* CHUNK_SIZE* CHUNK_SIZE>& blocks,
+    const PaddedBlocks& padded,
     const glm::ivec3& chunkBase,
-    const GetBlockFn& getBlockWorld,
-    int cubeNetW, int cubeNetH,
     IsSolidFn isSolid,
-    std::vector<VoxelVertex>& outVerts)
+    std::vector<PackedQuad>& outQuads)
 {
-    outVerts.clear();
-    outVerts.reserve(8192);
+    outQuads.clear();
+    outQuads.reserve(1024);
 
     struct Cell { bool empty = true; uint32_t key = 0; };
     std::vector<Cell> mask(CHUNK_SIZE * CHUNK_SIZE);
 
+    // padded-array strides per axis
+    const int stride[3] = { 1, PADDED_SIZE, PADDED_SIZE * PADDED_SIZE };
+
     for (int axis = 0; axis < 3; axis++)
     {
         int u = (axis + 1) % 3;
@@ -172,18 +180,17 @@ static void BuildGreedyPass(
 
         for (int s = 0; s <= CHUNK_SIZE; s++)
         {
-            // Build mask
+            // Build mask. b walks the slice at s, a is one step back along axis.
+            glm::ivec3 b0(0);
+            b0[axis] = s;
+            const int sliceBase = PaddedIdx(b0.x, b0.y, b0.z);
+
             for (int j = 0; j < CHUNK_SIZE; j++)
                 for (int i = 0; i < CHUNK_SIZE; i++)
                 {
-                    glm::ivec3 a(0), b(0);
-                    a[axis] = s - 1;
-                    b[axis] = s;
-                    a[u] = i; a[v] = j;
-                    b[u] = i; b[v] = j;
-
-                    Block A = GetBlockLocalOrWorld(blocks, chunkBase, getBlockWorld, a.x, a.y, a.z);
-                    Block B = GetBlockLocalOrWorld(blocks, chunkBase, getBlockWorld, b.x, b.y, b.z);
+                    int ib = sliceBase + i * stride[u] + j * stride[v];
+                    Block A = padded[ib - stride[axis]];
+                    Block B = padded[ib];
 
                     bool aSolid = isSolid(A);
                     bool bSolid = isSolid(B);
@@ -193,13 +200,14 @@ static void BuildGreedyPass(
                     if (aSolid != bSolid)
                     {
                         bool solidIsA = aSolid;
-                        glm::ivec3 solidLocal = solidIsA ? a : b;
 
                         // Only the chunk that OWNS the solid voxel emits the face.
-                        if (solidLocal.x >= 0 && solidLocal.x < CHUNK_SIZE &&
-                            solidLocal.y >= 0 && solidLocal.y < CHUNK_SIZE &&
-                            solidLocal.z >= 0 && solidLocal.z < CHUNK_SIZE)
+                        if (solidIsA ? (s > 0) : (s < CHUNK_SIZE))
                         {
+                            glm::ivec3 solidLocal(0);
+                            solidLocal[axis] = solidIsA ? s - 1 : s;
+                            solidLocal[u] = i; solidLocal[v] = j;
+
                             Block faceBlock  = solidIsA ? A : B;
                             Block otherBlock = solidIsA ? B : A;
                             int faceIndex = axis * 2 + (solidIsA ? 0 : 1);
@@ -277,57 +285,7 @@ static void BuildGreedyPass(
                         if (!stop) h++;
                     }
 
-                    Block faceBlock = KeyBlock(key);
-                    int faceIndex = KeyFace(key);
-                    glm::ivec2 tile = KeyTile(key);
-
-                    glm::ivec3 p0(0), p1(0), p2(0), p3(0);
-                    p0[axis] = s; p1[axis] = s; p2[axis] = s; p3[axis] = s;
-                    p0[u] = i;     p0[v] = j;
-                    p1[u] = i + w; p1[v] = j;
-                    p2[u] = i + w; p2[v] = j + h;
-                    p3[u] = i;     p3[v] = j + h;
-
-                    glm::vec3 Q[4] = {
-                        glm::vec3(chunkBase + p0),
-                        glm::vec3(chunkBase + p1),
-                        glm::vec3(chunkBase + p2),
-                        glm::vec3(chunkBase + p3),
-                    };
-
-                    glm::vec3 P[4];
-                    for (int ci = 0; ci < 4; ci++) {
-                        P[ci] = Q[FACE_Q_MAP[faceIndex][ci]];
-                    }
-
-                    // UV4 convention:
-// edge 0->1 is V direction, edge 1->2 is U direction
-float vSpan = glm::length(P[1] - P[0]); // becomes how many blocks tall
-float uSpan = glm::length(P[2] - P[1]); // becomes how many blocks wide
-
-                    glm::vec2 faceUV[4];
-                    GetCubeNetUVsTile(faceIndex, tile.x, tile.y, cubeNetW, cubeNetH, faceUV);
-
-                    glm::vec3 normal = FACES[faceIndex].normal;
-                    float layer = (float)BlockLayer(faceBlock);
-                    auto push = [&](int ci) {
-                        VoxelVertex v{};
-                        v.pos = P[ci];
-
-                        // IMPORTANT: make UVs tile per-voxel across greedy quads
-                        v.localUV = glm::vec2(UV4[ci].x * uSpan, UV4[ci].y * vSpan);
-
-                        v.normal = normal;
-                        v.layer = layer;
-                        v.tile = glm::vec2((float)tile.x, (float)tile.y);
-                        outVerts.push_back(v);
-                        };
-                    //auto push = [&](int ci) {
-                    //    outVerts.push_back({ P[ci], faceUV[ci], normal, layer });
-                    //    };
-
-                    push(0); push(1); push(2);
-                    push(0); push(2); push(3);
+                    EmitGreedyQuad(axis, s, i, j, w, h, key, outQuads);
 
                     for (int yy = 0; yy < h; yy++)
                         for (int xx = 0; xx < w; xx++)
@@ -341,22 +299,335 @@ float uSpan = glm::length(P[2] - P[1]); // becomes how many blocks wide
 }
 
 ChunkMeshData BuildChunkMeshGreedy(
-    const std::array<Block, CHUNK_SIZE* CHUNK_SIZE* CHUNK_SIZE>& blocks,
+    const PaddedBlocks& padded,
     const glm::ivec3& chunkBase,
-    const GetBlockFn& getBlockWorld,
-    int cubeNetW, int cubeNetH)
+    uint8_t passes)
 {
     ChunkMeshData out;
+    out.origin = chunkBase;
 
     // Opaque pass: treat water as "air"
-    BuildGreedyPass(blocks, chunkBase, getBlockWorld, cubeNetW, cubeNetH,
-        [](Block b) { return IsOpaque(b); },
-        out.opaque);
+    if (passes & MeshPassBit(MeshPass::Opaque))
+        BuildGreedyPass(padded, chunkBase,
+            [](Block b) { return IsOpaque(b); },
+            out.opaque);
 
     // Water pass: only water is solid
-    BuildGreedyPass(blocks, chunkBase, getBlockWorld, cubeNetW, cubeNetH,
-        [](Block b) { return b == Block::Water; },
-        out.water);
+    if (passes & MeshPassBit(MeshPass::Water))
+        BuildGreedyPass(padded, chunkBase,
+            [](Block b) { return b == Block::Water; },
+            out.water);
+
+    return out;
+}
+// ----------------------------------------------------------------------------
+// 3) BINARY GREEDY MESHER
+//
+// Same quads as BuildChunkMeshGreedy (emitted in a different order), but the
+// per-cell work is done on bitmasks:
+//  - every axis-aligned column of the padded volume becomes one 18-bit word
+//    (bit k = local coord k-1), one word set per block class
+//  - exposed faces for a whole column are  solid & (exposedTo >> 1)  for +axis
+//    and  solid & (exposedTo << 1)  for -axis
+//  - face bits are scattered into 16x16 bit planes per face and slice, split
+//    by greedy key, and merged with ctz / row-mask tests
+// Merging each key on its own plane gives exactly the rectangles the
+// per-cell mask produces, since cells of other keys never affect a key's
+// scan order or its width/height tests.
+// ----------------------------------------------------------------------------
+
+static constexpr uint32_t BIN_INNER = ((1u << CHUNK_SIZE) - 1u) << 1; // bits for local 0..15
+
+static constexpr uint32_t BIN_COLUMN = (1u << PADDED_SIZE) - 1u;        // all 18 bits
+
+struct BinaryColumns {
+    // [axis][u + CHUNK_SIZE * v], u/v = (axis+1, axis+2) like the greedy slices.
+    // Air is whatever is neither.
+    uint32_t opaque[3][CHUNK_SIZE * CHUNK_SIZE] = {};
+    uint32_t water[3][CHUNK_SIZE * CHUNK_SIZE] = {};
+};
+
+// One greedy key's cells on one slice: row j, bit i.
+struct KeyPlane {
+    uint32_t key = 0;
+    uint16_t rows[CHUNK_SIZE] = {};
+};
+
+// A slice of one face direction holds at most one key per non-air block type
+// and tile that face can take (TILE_TOP, TILE_BOTTOM or its SIDE_TILE).
+static constexpr int TILES_PER_FACE = 3;
+static constexpr int MAX_SLICE_KEYS = 32;
+static_assert((BLOCK_TYPE_COUNT - 1) * TILES_PER_FACE <= MAX_SLICE_KEYS,
+    "more block types than BuildBinaryPass's key array holds");
+
+static inline int Ctz(uint32_t x)
+{
+#if defined(_MSC_VER)
+    unsigned long i;
+    _BitScanForward(&i, x);
+    return (int)i;
+#else
+    return __builtin_ctz(x);
+#endif
+}
+
+// Bit i set = byte i of v equals c (SWAR, exact per byte; little-endian load).
+static inline uint32_t ByteEqMask8(uint64_t v, uint8_t c)
+{
+    const uint64_t lo7 = 0x7F7F7F7F7F7F7F7Full;
+    uint64_t y = v ^ (0x0101010101010101ull * c);           // matching bytes -> 0
+    uint64_t t = ((y & lo7) + lo7) | y;                       // high bit set unless byte == 0
+    uint64_t zeroHi = ~t & ~lo7;                              // 0x80 in each zero byte
+    return (uint32_t)(((zeroHi >> 7) * 0x0102040810204080ull) >> 56);
+}
+
+// In-place 16x16 bit-matrix transpose: bit x of a[y] <-> bit y of a[x].
+static void Transpose16(uint16_t a[16])
+{
+    uint16_t m = 0x00FF;
+    for (unsigned j = 8; j; j >>= 1, m ^= (uint16_t)(m << j))
+        for (unsigned k = 0; k < 16; k = ((k | j) + 1) & ~j) {
+            uint16_t t = (uint16_t)((a[k] ^ (a[k | j] << j)) & (uint16_t)~m);
+            a[k] ^= t;
+            a[k | j] ^= (uint16_t)(t >> j);
+        }
+}
+
+static void BuildBinaryColumns(const PaddedBlocks& padded, BinaryColumns& cols)
+{
+    auto opaqueBit = [](Block b) { return (uint32_t)(b != Block::Air && b != Block::Water); };
+    auto waterBit  = [](Block b) { return (uint32_t)(b == Block::Water); };
+
+    // One padded X row (x = -1..16) is exactly one X column. The 16 inner
+    // cells are classified 8 at a time.
+    for (int z = 0; z < CHUNK_SIZE; z++)
+        for (int y = 0; y < CHUNK_SIZE; y++)
+        {
+            const Block* row = &padded[PaddedIdx(-1, y, z)];
+
+            uint64_t lo, hi;
+            std::memcpy(&lo, row + 1, 8);
+            std::memcpy(&hi, row + 9, 8);
+
+            uint32_t air = (uint32_t)(row[0] == Block::Air)
+                | (ByteEqMask8(lo, (uint8_t)Block::Air) << 1)
+                | (ByteEqMask8(hi, (uint8_t)Block::Air) << 9)
+                | ((uint32_t)(row[PADDED_SIZE - 1] == Block::Air) << (PADDED_SIZE - 1));
+            uint32_t water = waterBit(row[0])
+                | (ByteEqMask8(lo, (uint8_t)Block::Water) << 1)
+                | (ByteEqMask8(hi, (uint8_t)Block::Water) << 9)
+                | (waterBit(row[PADDED_SIZE - 1]) << (PADDED_SIZE - 1));
+
+            cols.opaque[0][y + CHUNK_SIZE * z] = ~(air | water) & BIN_COLUMN;
+            cols.water[0][y + CHUNK_SIZE * z] = water;
+        }
+
+    // Y and Z columns over the chunk's own voxels are transposes of the
+    // X columns' inner 16 bits: per z-layer for Y, per y-layer for Z.
+    auto transposeInto = [](const uint32_t* xCols, uint32_t* yCols, uint32_t* zCols) {
+        uint16_t m[CHUNK_SIZE];
+        for (int z = 0; z < CHUNK_SIZE; z++) {
+            for (int y = 0; y < CHUNK_SIZE; y++) m[y] = (uint16_t)(xCols[y + CHUNK_SIZE * z] >> 1);
+            Transpose16(m); // m[x] bit y
+            for (int x = 0; x < CHUNK_SIZE; x++) yCols[z + CHUNK_SIZE * x] = (uint32_t)m[x] << 1;
+        }
+        for (int y = 0; y < CHUNK_SIZE; y++) {
+            for (int z = 0; z < CHUNK_SIZE; z++) m[z] = (uint16_t)(xCols[y + CHUNK_SIZE * z] >> 1);
+            Transpose16(m); // m[x] bit z
+            for (int x = 0; x < CHUNK_SIZE; x++) zCols[x + CHUNK_SIZE * y] = (uint32_t)m[x] << 1;
+        }
+    };
+    transposeInto(cols.opaque[0], cols.opaque[1], cols.opaque[2]);
+    transposeInto(cols.water[0], cols.water[1], cols.water[2]);
+
+    // Y and Z aprons (the X apron came in with the rows above)
+    for (int a = 0; a < CHUNK_SIZE; a++)
+        for (int x = 0; x < CHUNK_SIZE; x++)
+        {
+            Block yLo = padded[PaddedIdx(x, -1, a)], yHi = padded[PaddedIdx(x, CHUNK_SIZE, a)];
+            cols.opaque[1][a + CHUNK_SIZE * x] |= opaqueBit(yLo) | (opaqueBit(yHi) << (PADDED_SIZE - 1));
+            cols.water[1][a + CHUNK_SIZE * x]  |= waterBit(yLo)  | (waterBit(yHi) << (PADDED_SIZE - 1));
+
+            Block zLo = padded[PaddedIdx(x, a, -1)], zHi = padded[PaddedIdx(x, a, CHUNK_SIZE)];
+            cols.opaque[2][x + CHUNK_SIZE * a] |= opaqueBit(zLo) | (opaqueBit(zHi) << (PADDED_SIZE - 1));
+            cols.water[2][x + CHUNK_SIZE * a]  |= waterBit(zLo)  | (waterBit(zHi) << (PADDED_SIZE - 1));
+        }
+}
+
+// waterPass: solid = water, faces only against air, only the voxel's outward
+// face, always TILE_TOP (the rules BuildGreedyPass applies to water).
+static void BuildBinaryPass(
+    const PaddedBlocks& padded,
+    const BinaryColumns& cols,
+    const glm::ivec3& chunkBase,
+    bool waterPass,
+    int uniformTopFi,
+    std::vector<PackedQuad>& outQuads)
+{
+    outQuads.clear();
+    outQuads.reserve(1024);
+
+    // planes[fi][s][j] bit i = face fi present on slice s at (i,j)
+    uint16_t planes[6][CHUNK_SIZE + 1][CHUNK_SIZE] = {};
+    uint32_t sliceUsed[6] = {}; // bit s = planes[fi][s] not empty
+
+    for (int axis = 0; axis < 3; axis++)
+    {
+        const uint32_t* solid = waterPass ? cols.water[axis] : cols.opaque[axis];
+
+        for (int col = 0; col < CHUNK_SIZE * CHUNK_SIZE; col++)
+        {
+            uint32_t sCol = solid[col];
+            if (!sCol) continue;
+
+            uint32_t air = ~(cols.opaque[axis][col] | cols.water[axis][col]) & BIN_COLUMN;
+            uint32_t exposed = waterPass ? air : (air | cols.water[axis][col]);
+
+            uint32_t pos = sCol & (exposed >> 1) & BIN_INNER;
+            uint32_t neg = sCol & (exposed << 1) & BIN_INNER;
+
+            uint16_t bit = (uint16_t)(1u << (col % CHUNK_SIZE));
+            int j = col / CHUNK_SIZE;
+
+            // voxel at bit k has local coord k-1; its +face sits on slice k,
+            // its -face on slice k-1
+            for (; pos; pos &= pos - 1) {
+                int s = Ctz(pos);
+                planes[axis * 2][s][j] |= bit;
+                sliceUsed[axis * 2] |= 1u << s;
+            }
+            for (; neg; neg &= neg - 1) {
+                int s = Ctz(neg) - 1;
+                planes[axis * 2 + 1][s][j] |= bit;
+                sliceUsed[axis * 2 + 1] |= 1u << s;
+            }
+        }
+    }
+
+    KeyPlane keys[MAX_SLICE_KEYS];
+
+    for (int axis = 0; axis < 3; axis++)
+    {
+        int u = (axis + 1) % 3;
+        int v = (axis + 2) % 3;
+
+        for (int s = 0; s <= CHUNK_SIZE; s++)
+            for (int fi = axis * 2; fi <= axis * 2 + 1; fi++)
+            {
+                if (!(sliceUsed[fi] & (1u << s))) continue;
+                const uint16_t* plane = planes[fi][s];
+
+                // Split the plane by greedy key.
+                int keyCount = 0;
+                int last = -1;
+                for (int j = 0; j < CHUNK_SIZE; j++)
+                    for (uint32_t row = plane[j]; row; row &= row - 1)
+                    {
+                        int i = Ctz(row);
+
+                        glm::ivec3 solidLocal(0);
+                        solidLocal[axis] = (fi & 1) ? s : s - 1;
+                        solidLocal[u] = i; solidLocal[v] = j;
+
+                        Block faceBlock = padded[PaddedIdx(solidLocal.x, solidLocal.y, solidLocal.z)];
+
+                        glm::ivec2 tile;
+                        if (uniformTopFi >= 0) {
+                            if (waterPass && fi != uniformTopFi) continue;
+                            tile = (waterPass || fi == uniformTopFi) ? TILE_TOP
+                                 : (fi == (uniformTopFi ^ 1)) ? TILE_BOTTOM
+                                 : SIDE_TILE[fi];
+                        }
+                        else {
+                            glm::ivec3 solidWorld = chunkBase + solidLocal;
+                            if (waterPass) {
+                                if (fi != DominantTopFaceIndex(solidWorld)) continue;
+                                tile = TILE_TOP;
+                            }
+                            else {
+                                tile = TileForFaceOnVoxel(fi, solidWorld);
+                            }
+                        }
+
+                        uint32_t key = MakeGreedyKey(faceBlock, fi, tile);
+                        if (last < 0 || keys[last].key != key) {
+                            last = 0;
+                            while (last < keyCount && keys[last].key != key) last++;
+                            if (last == keyCount) {
+                                keys[keyCount] = KeyPlane{};
+                                keys[keyCount++].key = key;
+                            }
+                        }
+                        keys[last].rows[j] |= (uint16_t)(1u << i);
+                    }
+
+                // Greedy-merge each key's plane.
+                for (int k = 0; k < keyCount; k++)
+                {
+                    uint16_t* rows = keys[k].rows;
+                    for (int j = 0; j < CHUNK_SIZE; j++)
+                        while (rows[j])
+                        {
+                            uint32_t row = rows[j];
+                            int i = Ctz(row);
+                            int w = Ctz(~(row >> i));
+                            uint16_t m = (uint16_t)(((1u << w) - 1u) << i);
+
+                            int h = 1;
+                            while (j + h < CHUNK_SIZE && (rows[j + h] & m) == m) {
+                                rows[j + h] &= (uint16_t)~m;
+                                h++;
+                            }
+                            rows[j] &= (uint16_t)~m;
+
+                            EmitGreedyQuad(axis, s, i, j, w, h, keys[k].key, outQuads);
+                        }
+                }
+            }
+    }
+}
+
+ChunkMeshData BuildChunkMeshBinary(
+    const PaddedBlocks& padded,
+    const glm::ivec3& chunkBase,
+    uint8_t passes)
+{
+    ChunkMeshData out;
+    out.origin = chunkBase;
+
+    BinaryColumns cols;
+    BuildBinaryColumns(padded, cols);
+
+    // The per-voxel "top" face regions are convex cones around the planet
+    // center, so if all 8 corner voxels agree the whole chunk does and the
+    // tile choice becomes a per-face constant.
+    int uniformTopFi = DominantTopFaceIndex(chunkBase);
+    for (int c = 1; c < 8 && uniformTopFi >= 0; c++) {
+        glm::ivec3 corner = chunkBase + glm::ivec3(
+            (c & 1) ? CHUNK_SIZE - 1 : 0,
+            (c & 2) ? CHUNK_SIZE - 1 : 0,
+            (c & 4) ? CHUNK_SIZE - 1 : 0);
+        if (DominantTopFaceIndex(corner) != uniformTopFi) uniformTopFi = -1;
+    }
+
+    if (passes & MeshPassBit(MeshPass::Opaque))
+        BuildBinaryPass(padded, cols, chunkBase, false, uniformTopFi, out.opaque);
+    if (passes & MeshPassBit(MeshPass::Water))
+        BuildBinaryPass(padded, cols, chunkBase, true, uniformTopFi, out.water);
 
     return out;
-}
\ No newline at end of file
+}
+
+ChunkMeshData BuildChunkMeshWith(
+    MesherKind kind,
+    const PaddedBlocks& padded,
+    const glm::ivec3& chunkBase,
+    uint8_t passes)
+{
+    switch (kind) {
+    case MesherKind::FaceCulled: return BuildChunkMeshFaceCulled(padded, chunkBase);
+    case MesherKind::Binary:     return BuildChunkMeshBinary(padded, chunkBase, passes);
+    case MesherKind::Greedy:
+    default:                     return BuildChunkMeshGreedy(padded, chunkBase, passes);
+    }
+}
@@ -1,28 +1,61 @@
 #pragma once
 #include <array>
-#include <functional>
 #include <vector>
 #include <glm.hpp>
 
 #include <../voxel/Chunk.h>
 #include <../voxel/Voxel.h>
-#include "VoxelVertex.h"
+#include "PackedQuad.h"
 
+// Quads are chunk-local; origin is the chunk's min corner in world voxels.
 struct ChunkMeshData {
-    std::vector<VoxelVertex> opaque;
-    std::vector<VoxelVertex> water;
+    glm::ivec3 origin{ 0 };
+    std::vector<PackedQuad> opaque;
+    std::vector<PackedQuad> water;
 };
 
-using GetBlockFn = std::function<Block(int, int, int)>;
+// Mesher input: the chunk plus a one-voxel apron on every side, so border
+// cells are plain array reads. Local coords run -1..CHUNK_SIZE on each axis.
+// Only the six face layers of the apron are read; edges/corners stay Air.
+static constexpr int PADDED_SIZE = CHUNK_SIZE + 2;
+using PaddedBlocks = std::array<Block, PADDED_SIZE* PADDED_SIZE* PADDED_SIZE>;
+
+inline int PaddedIdx(int x, int y, int z) {
+    return (x + 1) + PADDED_SIZE * ((y + 1) + PADDED_SIZE * (z + 1));
+}
+
+void CopyChunkIntoPadded(const BlockStorage& blocks, PaddedBlocks& out);
+
+// Copies the layer of `neighbor` that touches us across FACES[faceIndex].
+void CopyNeighborFaceIntoPadded(int faceIndex, const BlockStorage& neighbor, PaddedBlocks& out);
 
 ChunkMeshData BuildChunkMeshFaceCulled(
-    const std::array<Block, CHUNK_SIZE* CHUNK_SIZE* CHUNK_SIZE>& blocks,
-    const glm::ivec3& chunkBase,
-    const GetBlockFn& getBlockWorld,
-    int cubeNetW, int cubeNetH);
+    const PaddedBlocks& padded,
+    const glm::ivec3& chunkBase);
+
+// Which passes a build emits, one bit per MeshPass. Only the chunk's own
+// voxels emit faces, so a chunk without water (per its ChunkSummary) can
+// skip the water pass and one without opaque blocks the opaque pass.
+static constexpr uint8_t MESH_PASSES_ALL = 0x3;
+inline uint8_t MeshPassBit(MeshPass p) { return (uint8_t)(1u << (int)p); }
 
 ChunkMeshData BuildChunkMeshGreedy(
-    const std::array<Block, CHUNK_SIZE* CHUNK_SIZE* CHUNK_SIZE>& blocks,
+    const PaddedBlocks& padded,
+    const glm::ivec3& chunkBase,
+    uint8_t passes = MESH_PASSES_ALL);
+
+// Bitmask version of the greedy mesher: same quads and keys, different order.
+ChunkMeshData BuildChunkMeshBinary(
+    const PaddedBlocks& padded,
+    const glm::ivec3& chunkBase,
+    uint8_t passes = MESH_PASSES_ALL);
+
+enum class MesherKind : uint8_t { FaceCulled, Greedy, Binary };
+
+// passes only matter to the greedy meshers; face culling visits solid
+// voxels only and gets nothing out of skipping a pass
+ChunkMeshData BuildChunkMeshWith(
+    MesherKind kind,
+    const PaddedBlocks& padded,
     const glm::ivec3& chunkBase,
-    const GetBlockFn& getBlockWorld,
-    int cubeNetW, int cubeNetH);
\ No newline at end of file
+    uint8_t passes = MESH_PASSES_ALL);
@@ -0,0 +1,22 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+#include <../voxel/MeshSink.h>
+#include "ChunkMesher.h"
+
+// Keeps every uploaded mesh in system memory (headless runs, tests, export).
+class CpuMeshSink : public MeshSink {
+public:
+    void Upload(ChunkMeshSlot& slot, ChunkMeshData& mesh) override;
+    void Release(ChunkMeshSlot& slot) override;
+
+    const ChunkMeshData* Find(const ChunkMeshSlot& slot) const;
+
+    size_t ResidentMeshes() const { return meshes_.size() - freeIds_.size(); }
+    size_t ResidentBytes() const;
+
+private:
+    std::vector<ChunkMeshData> meshes_;  // index = id - 1
+    std::vector<uint32_t> freeIds_;
+};
@@ -0,0 +1,58 @@
+#include "CpuMeshSink.h"
+
+// --- NullMeshSink ------------------------------------------------------------
+
+void NullMeshSink::Upload(ChunkMeshSlot& slot, ChunkMeshData& mesh)
+{
+    slot.opaqueCount = (int)mesh.opaque.size();
+    slot.waterCount = (int)mesh.water.size();
+}
+
+// --- CpuMeshSink -------------------------------------------------------------
+
+void CpuMeshSink::Upload(ChunkMeshSlot& slot, ChunkMeshData& mesh)
+{
+    if (slot.id == 0) {
+        if (!freeIds_.empty()) {
+            slot.id = freeIds_.back();
+            freeIds_.pop_back();
+        }
+        else {
+            meshes_.emplace_back();
+            slot.id = (uint32_t)meshes_.size();
+        }
+    }
+
+    slot.opaqueCount = (int)mesh.opaque.size();
+    slot.waterCount = (int)mesh.water.size();
+    ChunkMeshData& dst = meshes_[slot.id - 1];
+    dst = std::move(mesh);
+    // meshers reserve worst-case; don't keep that around per chunk
+    dst.opaque.shrink_to_fit();
+    dst.water.shrink_to_fit();
+}
+
+void CpuMeshSink::Release(ChunkMeshSlot& slot)
+{
+    if (slot.id != 0) {
+        ChunkMeshData& m = meshes_[slot.id - 1];
+        m.opaque = {};
+        m.water = {};
+        freeIds_.push_back(slot.id);
+    }
+    slot = {};
+}
+
+const ChunkMeshData* CpuMeshSink::Find(const ChunkMeshSlot& slot) const
+{
+    if (slot.id == 0 || slot.id > meshes_.size()) return nullptr;
+    return &meshes_[slot.id - 1];
+}
+
+size_t CpuMeshSink::ResidentBytes() const
+{
+    size_t bytes = 0;
+    for (const ChunkMeshData& m : meshes_)
+        bytes += (m.opaque.capacity() + m.water.capacity()) * sizeof(PackedQuad);
+    return bytes;
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <cstdint>
+#include <glm.hpp>
+
+#include <../voxel/Mesher.h>
+#include "VoxelVertex.h"
+
+// One greedy quad in 8 bytes, stored once per quad and expanded to two
+// triangles in voxel.vs (vertex pulling from an SSBO, gl_VertexID / 6 = quad).
+// Positions are chunk-local; the chunk origin is the per-instance aChunkOrigin
+// attribute, which each indirect draw command selects with its baseInstance.
+//
+//   a:  0..4  p0.x  (0..16)       b:  0..7  texture layer
+//       5..9  p0.y                    8..9  tile.x (cube-net col)
+//      10..14 p0.z                   10..11 tile.y (cube-net row)
+//      15..18 w - 1 (along u)
+//      19..22 h - 1 (along v)
+//      23..25 face (FACES index)
+//
+// p0 is the quad's min corner; u/v are (axis+1, axis+2) of the face axis,
+// same convention as the greedy slices.
+struct PackedQuad {
+    uint32_t a = 0;
+    uint32_t b = 0;
+
+    int X() const { return (int)(a & 31u); }
+    int Y() const { return (int)((a >> 5) & 31u); }
+    int Z() const { return (int)((a >> 10) & 31u); }
+    int W() const { return (int)((a >> 15) & 15u) + 1; }
+    int H() const { return (int)((a >> 19) & 15u) + 1; }
+    int Face() const { return (int)((a >> 23) & 7u); }
+    int Layer() const { return (int)(b & 255u); }
+    glm::ivec2 Tile() const { return glm::ivec2((int)((b >> 8) & 3u), (int)((b >> 10) & 3u)); }
+};
+static_assert(sizeof(PackedQuad) == 8, "PackedQuad must stay 8 bytes (voxel.vs reads uvec2)");
+
+inline PackedQuad PackQuad(const glm::ivec3& p0, int w, int h, int face, int layer, const glm::ivec2& tile)
+{
+    PackedQuad q;
+    q.a = (uint32_t)p0.x | ((uint32_t)p0.y << 5) | ((uint32_t)p0.z << 10) |
+        ((uint32_t)(w - 1) << 15) | ((uint32_t)(h - 1) << 19) | ((uint32_t)face << 23);
+    q.b = (uint32_t)layer | ((uint32_t)tile.x << 8) | ((uint32_t)tile.y << 10);
+    return q;
+}
+
+// Map from "canonical quad corners" Q[0..3] (made from (i,j,w,h) in u/v order)
+// into the corner order expected by FACES[faceIndex].c[0..3] + GetCubeNetUVsTile.
+// voxel.vs has a copy of this table.
+static const uint8_t FACE_Q_MAP[6][4] = {
+    {0,1,2,3}, // +X
+    {3,2,1,0}, // -X
+    {1,2,3,0}, // +Y
+    {0,3,2,1}, // -Y
+    {1,2,3,0}, // +Z
+    {0,3,2,1}, // -Z
+};
+
+// two triangles per quad, as corner indices into P[]
+static const int QUAD_TRI[6] = { 0, 1, 2, 0, 2, 3 };
+
+// CPU mirror of voxel.vs: the six world-space vertices of a quad.
+// For tools/tests; the renderer never expands quads on the CPU.
+inline void UnpackQuad(const PackedQuad& q, const glm::ivec3& origin, VoxelVertex out[6])
+{
+    int face = q.Face();
+    int axis = face >> 1;
+    int u = (axis + 1) % 3;
+    int v = (axis + 2) % 3;
+
+    glm::ivec3 p0 = origin + glm::ivec3(q.X(), q.Y(), q.Z());
+    glm::ivec3 du(0), dv(0);
+    du[u] = q.W();
+    dv[v] = q.H();
+
+    glm::vec3 Q[4] = {
+        glm::vec3(p0),
+        glm::vec3(p0 + du),
+        glm::vec3(p0 + du + dv),
+        glm::vec3(p0 + dv),
+    };
+
+    glm::vec3 P[4];
+    for (int ci = 0; ci < 4; ci++)
+        P[ci] = Q[FACE_Q_MAP[face][ci]];
+
+    // edge 0->1 is V direction, edge 1->2 is U direction (axis-aligned)
+    glm::vec3 e0 = glm::abs(P[1] - P[0]);
+    glm::vec3 e1 = glm::abs(P[2] - P[1]);
+    float vSpan = e0.x + e0.y + e0.z;
+    float uSpan = e1.x + e1.y + e1.z;
+
+    glm::ivec2 tile = q.Tile();
+    for (int k = 0; k < 6; k++) {
+        int ci = QUAD_TRI[k];
+        VoxelVertex& vx = out[k];
+        vx.pos = P[ci];
+        vx.localUV = glm::vec2(UV4[ci].x * uSpan, UV4[ci].y * vSpan);
+        vx.normal = FACES[face].normal;
+        vx.layer = (float)q.Layer();
+        vx.tile = glm::vec2((float)tile.x, (float)tile.y);
+    }
+}
@@ -0,0 +1,152 @@
+#include <random>
+#include <vector>
+
+#include "src/mesh/ArenaAllocator.h"
+#include "Test.h"
+
+namespace {
+
+bool Consistent(const ArenaAllocator& a)
+{
+    ArenaAllocator::Stats s = a.GetStats();
+    return s.used + s.freeTotal == s.capacity && s.largestFree <= s.freeTotal &&
+        (s.freeTotal == 0) == (s.freeBlocks == 0);
+}
+
+} // namespace
+
+TEST(Arena_AllocateCarvesFromFront)
+{
+    ArenaAllocator a(100);
+    CHECK(a.Allocate(10) == 0);
+    CHECK(a.Allocate(20) == 10);
+    CHECK(a.Allocate(70) == 30);
+    CHECK(a.Allocate(1) == ArenaAllocator::INVALID);
+    CHECK(a.Allocate(0) == ArenaAllocator::INVALID);
+
+    ArenaAllocator::Stats s = a.GetStats();
+    CHECK(s.used == 100);
+    CHECK(s.freeBlocks == 0);
+    CHECK(s.allocations == 3);
+    CHECK(s.Fragmentation() == 0.0f);
+}
+
+TEST(Arena_FreeCoalescesBothNeighbors)
+{
+    ArenaAllocator a(30);
+    uint32_t x = a.Allocate(10), y = a.Allocate(10), z = a.Allocate(10);
+
+    a.Free(x, 10);
+    a.Free(z, 10);
+    CHECK(a.GetStats().freeBlocks == 2);
+    CHECK(a.GetStats().largestFree == 10);
+    CHECK(a.GetStats().Fragmentation() == 0.5f);
+
+    // y sits between two free blocks: all three become one
+    a.Free(y, 10);
+    ArenaAllocator::Stats s = a.GetStats();
+    CHECK(s.freeBlocks == 1);
+    CHECK(s.largestFree == 30);
+    CHECK(s.used == 0 && s.allocations == 0);
+    CHECK(a.Allocate(30) == 0);
+}
+
+TEST(Arena_BestFitPicksSmallestBlockThatFits)
+{
+    ArenaAllocator a(100);
+    uint32_t b0 = a.Allocate(10);
+    a.Allocate(1);
+    uint32_t b1 = a.Allocate(5);
+    a.Allocate(1);
+    uint32_t b2 = a.Allocate(8);
+    a.Allocate(75); // leaves nothing at the tail
+    a.Free(b0, 10);
+    a.Free(b1, 5);
+    a.Free(b2, 8);
+
+    CHECK(a.Allocate(6) == b2);      // 8 is the tightest fit
+    CHECK(a.Allocate(5) == b1);      // exact fit
+    CHECK(a.Allocate(11) == ArenaAllocator::INVALID);
+    CHECK(a.Allocate(3) == b0);      // only the 10 is left
+    CHECK(a.GetStats().largestFree == 7);
+    CHECK(Consistent(a));
+}
+
+TEST(Arena_GrowMergesWithFreeTail)
+{
+    ArenaAllocator a(16);
+    uint32_t x = a.Allocate(8);
+    a.Allocate(4);
+    CHECK(a.GetStats().largestFree == 4);
+
+    a.Grow(32);
+    ArenaAllocator::Stats s = a.GetStats();
+    CHECK(s.capacity == 32);
+    CHECK(s.freeBlocks == 1);         // the old 4-unit tail merged with the new 16
+    CHECK(s.largestFree == 20);
+    CHECK(s.allocations == 2);
+    CHECK(a.Allocate(20) == 12);
+
+    a.Grow(16);                        // never shrinks
+    CHECK(a.Capacity() == 32);
+
+    a.Free(x, 8);
+    a.Grow(40);                        // full tail: the new space is its own block
+    CHECK(a.GetStats().freeBlocks == 2);
+    CHECK(Consistent(a));
+}
+
+TEST(Arena_GrowFromEmpty)
+{
+    ArenaAllocator a;
+    CHECK(a.Allocate(1) == ArenaAllocator::INVALID);
+    a.Grow(8);
+    CHECK(a.Allocate(8) == 0);
+    CHECK(a.GetStats().allocations == 1);
+}
+
+TEST(Arena_RandomChurnKeepsInvariants)
+{
+    struct Live { uint32_t offset, size; };
+    std::mt19937 rng(1234);
+    ArenaAllocator a(4096);
+    std::vector<Live> live;
+    std::vector<uint8_t> owner(a.Capacity(), 0); // 1 = allocated, catches overlaps
+
+    bool overlap = false;
+    for (int step = 0; step < 20000; step++) {
+        if (live.empty() || rng() % 2 != 0) {
+            uint32_t size = 1 + rng() % 64;
+            uint32_t off = a.Allocate(size);
+            if (off == ArenaAllocator::INVALID) {
+                a.Grow(a.Capacity() * 2);
+                owner.resize(a.Capacity(), 0);
+                off = a.Allocate(size);
+            }
+            REQUIRE(off != ArenaAllocator::INVALID);
+            REQUIRE(off + size <= a.Capacity());
+            for (uint32_t i = off; i < off + size; i++) {
+                overlap |= owner[i] != 0;
+                owner[i] = 1;
+            }
+            live.push_back({ off, size });
+        }
+        else {
+            size_t k = rng() % live.size();
+            for (uint32_t i = live[k].offset; i < live[k].offset + live[k].size; i++) owner[i] = 0;
+            a.Free(live[k].offset, live[k].size);
+            live[k] = live.back();
+            live.pop_back();
+        }
+    }
+    CHECK(!overlap);
+    CHECK(Consistent(a));
+    CHECK(a.GetStats().allocations == live.size());
+
+    // everything back: one block again, no fragmentation
+    for (const Live& l : live) a.Free(l.offset, l.size);
+    ArenaAllocator::Stats s = a.GetStats();
+    CHECK(s.used == 0);
+    CHECK(s.freeBlocks == 1);
+    CHECK(s.Fragmentation() == 0.0f);
+}
@@ -0,0 +1,80 @@
+#include <cstring>
+#include <random>
+
+#include "src/voxel/Chunk.h"
+#include "src/voxel/ChunkSummary.h"
+#include "Test.h"
+
+namespace {
+
+bool Same(const ChunkSummary& a, const ChunkSummary& b)
+{
+    return std::memcmp(a.counts, b.counts, sizeof(a.counts)) == 0 &&
+        a.opaque == b.opaque && a.opaqueFaces == b.opaqueFaces;
+}
+
+// edits blocks and s the way World::SetBlock does
+void Edit(BlockStorage& blocks, ChunkSummary& s, int x, int y, int z, Block b)
+{
+    Block was = blocks.Get(Idx(x, y, z));
+    blocks.Set(Idx(x, y, z), b);
+    UpdateSummary(s, blocks, x, y, z, was);
+}
+
+ChunkSummary Rescan(const BlockStorage& blocks)
+{
+    ChunkBlocks all;
+    blocks.Decode(all);
+    return Summarize(all);
+}
+
+} // namespace
+
+TEST(ChunkSummary_UpdateMatchesRescanOnRandomEdits)
+{
+    std::mt19937 rng(99);
+    BlockStorage blocks(Block::Stone);
+    ChunkSummary s = SummarizeUniform(Block::Stone);
+
+    bool ok = true;
+    for (int n = 0; n < 20000 && ok; n++) {
+        // mostly on the boundary, where opaqueFaces changes
+        auto coord = [&] { int r = rng() % 4; return r == 0 ? 0 : r == 1 ? CHUNK_SIZE - 1 : (int)(rng() % CHUNK_SIZE); };
+        int x = coord(), y = coord(), z = coord();
+        // opaque types far more often than not, so whole layers refill
+        Block b = (rng() % 8 == 0) ? ((rng() & 1) ? Block::Air : Block::Water) : Block::Stone;
+        Edit(blocks, s, x, y, z, b);
+        ok = Same(s, Rescan(blocks));
+    }
+    CHECK(ok);
+}
+
+TEST(ChunkSummary_UpdateSetsFaceWhenLayerCloses)
+{
+    BlockStorage blocks(Block::Air);
+    ChunkSummary s = SummarizeUniform(Block::Air);
+
+    // fill the +Y layer one voxel at a time; the bit only comes on with the last
+    constexpr int L = CHUNK_SIZE - 1;
+    for (int z = 0; z < CHUNK_SIZE; z++)
+        for (int x = 0; x < CHUNK_SIZE; x++) {
+            CHECK(!(s.opaqueFaces & (1u << 2)));
+            Edit(blocks, s, x, L, z, Block::Dirt);
+        }
+    CHECK(s.opaqueFaces == (1u << 2));
+    CHECK(s.opaque == CHUNK_SIZE * CHUNK_SIZE);
+    CHECK(Same(s, Rescan(blocks)));
+
+    // water isn't opaque: opens the layer again
+    Edit(blocks, s, 3, L, 7, Block::Water);
+    CHECK(s.opaqueFaces == 0);
+    CHECK(s.HasWater());
+    CHECK(Same(s, Rescan(blocks)));
+
+    // same opacity both ways: counts move, faces don't
+    Edit(blocks, s, 3, L, 7, Block::Air);
+    Edit(blocks, s, 3, L, 7, Block::Stone);
+    Edit(blocks, s, 3, L, 7, Block::Grass);
+    CHECK(s.opaqueFaces == (1u << 2));
+    CHECK(Same(s, Rescan(blocks)));
+}
@@ -0,0 +1,119 @@
+#include "src/voxel/ChunkGen.h"
+#include "src/voxel/ColdChunkCache.h"
+#include "src/voxel/World.h"
+#include "Test.h"
+
+namespace {
+
+BlockStorage Filled(Block b)
+{
+    BlockStorage s;
+    s.Fill(b);
+    return s;
+}
+
+void ConfigureSmallWorld(World& world)
+{
+    world.planet.baseRadius = 4096.f;
+    world.planet.maxHeight = 12.0f;
+    world.planet.noiseFreq = 3.0f;
+    world.planet.octaves = 5;
+    world.planet.seaLevelOffset = -2.0f;
+    world.SetGenWorkers(0);
+    world.SetMeshWorkers(0);
+    world.SetRenderDistance(1);
+    world.SetUnloadDistance(2);
+}
+
+} // namespace
+
+TEST(ColdCache_PutTakeRoundTrip)
+{
+    ColdChunkCache cache;
+    cache.Put(ChunkCoord{ 1, 2, 3 }, Filled(Block::Stone), SummarizeUniform(Block::Stone), 5);
+    CHECK(cache.GetStats().chunks == 1);
+
+    BlockStorage blocks;
+    ChunkSummary summary;
+    CHECK(!cache.Take(ChunkCoord{ 3, 2, 1 }, blocks, summary));
+    REQUIRE(cache.Take(ChunkCoord{ 1, 2, 3 }, blocks, summary));
+    CHECK(blocks.Get(0) == Block::Stone);
+    CHECK(summary.opaque == CHUNK_VOLUME);
+    CHECK(cache.GetStats().chunks == 0);
+    CHECK(cache.GetStats().bytes == 0);
+}
+
+TEST(ColdCache_PutTwiceReplaces)
+{
+    ColdChunkCache cache;
+    ChunkCoord cc{ 4, -5, 6 };
+    cache.Put(cc, Filled(Block::Stone), SummarizeUniform(Block::Stone), 1);
+    size_t oneEntry = cache.GetStats().bytes;
+    cache.Put(cc, Filled(Block::Dirt), SummarizeUniform(Block::Dirt), 2);
+
+    CHECK(cache.GetStats().chunks == 1);
+    CHECK(cache.GetStats().bytes == oneEntry);
+
+    // evicting everything must only see the one entry
+    cache.SetBudget(0);
+    CHECK(cache.GetStats().chunks == 0);
+    CHECK(cache.GetStats().bytes == 0);
+    CHECK(cache.GetStats().evicted == 1);
+
+    cache.SetBudget(1u << 20);
+    cache.Put(cc, Filled(Block::Stone), SummarizeUniform(Block::Stone), 1);
+    cache.Put(cc, Filled(Block::Dirt), SummarizeUniform(Block::Dirt), 2);
+    BlockStorage blocks;
+    ChunkSummary summary;
+    REQUIRE(cache.Take(cc, blocks, summary));
+    CHECK(blocks.Get(0) == Block::Dirt);
+    CHECK(!cache.Take(cc, blocks, summary));
+}
+
+TEST(ColdCache_EvictsLeastRecentlyVisible)
+{
+    ColdChunkCache cache;
+    for (int i = 0; i < 4; i++)
+        cache.Put(ChunkCoord{ i, 0, 0 }, Filled(Block::Stone), SummarizeUniform(Block::Stone), 10 - i);
+    size_t per = cache.GetStats().bytes / 4;
+    cache.SetBudget(2 * per);
+
+    BlockStorage blocks;
+    ChunkSummary summary;
+    CHECK(cache.Take(ChunkCoord{ 0, 0, 0 }, blocks, summary));   // visible at 10
+    CHECK(cache.Take(ChunkCoord{ 1, 0, 0 }, blocks, summary));   // 9
+    CHECK(!cache.Take(ChunkCoord{ 2, 0, 0 }, blocks, summary));  // 8, evicted
+    CHECK(!cache.Take(ChunkCoord{ 3, 0, 0 }, blocks, summary));  // 7, evicted
+}
+
+// Sky chunk edited, reverted and unloaded, then edited and unloaded again:
+// used to leave two order nodes for one entry, and evicting read past the
+// end of the entry map.
+TEST(ColdCache_WorldSkyChunkUnloadedTwice)
+{
+    World world;
+    ConfigureSmallWorld(world);
+
+    glm::vec3 near(0.0f, 0.0f, 4200.0f), far(640.0f, 0.0f, 4200.0f), fwd(1.0f, 0.0f, 0.0f);
+    glm::ivec3 v(0, 0, 4200 + CHUNK_SIZE); // one chunk above the camera's
+    ChunkCoord cc = WorldToChunk(v.x, v.y, v.z);
+    REQUIRE(ClassifyChunkShell(cc, world.planet) == ChunkShell::Sky);
+
+    world.UpdateStreaming(near, fwd);
+    CHECK(world.SetBlock(v.x, v.y, v.z, Block::Stone));
+    CHECK(world.SetBlock(v.x, v.y, v.z, Block::Air)); // back to generation: no journal entry
+    world.UpdateStreaming(far, fwd);
+    CHECK(world.GetStreamStats().coldChunks == 0); // plain sky comes back without the cold tier
+
+    world.UpdateStreaming(near, fwd);
+    CHECK(world.SetBlock(v.x, v.y, v.z, Block::Stone));
+    world.UpdateStreaming(far, fwd);
+    CHECK(world.GetStreamStats().coldChunks == 1);
+
+    world.SetColdBudget(0);
+    CHECK(world.GetStreamStats().coldChunks == 0);
+
+    // evicted, but the edit is in the journal
+    world.UpdateStreaming(near, fwd);
+    CHECK(world.GetBlock(v.x, v.y, v.z) == Block::Stone);
+}
@@ -0,0 +1,197 @@
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+#include "src/voxel/EditJournal.h"
+#include "Test.h"
+
+namespace {
+
+constexpr uint64_t PLANET_KEY = 0x5EED0001u;
+
+std::string FreshFile(const char* name)
+{
+    std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+    std::filesystem::remove(path.string() + ".tmp", ec);
+    return path.string();
+}
+
+uint64_t FileBytes(const std::string& path)
+{
+    std::error_code ec;
+    uint64_t n = std::filesystem::file_size(path, ec);
+    return ec ? 0 : n;
+}
+
+void AppendBytes(const std::string& path, size_t n)
+{
+    FILE* f = std::fopen(path.c_str(), "ab");
+    for (size_t i = 0; i < n; i++) std::fputc(0, f);
+    std::fclose(f);
+}
+
+Block Voxel(const EditJournal& journal, ChunkCoord cc, int i)
+{
+    BlockStorage blocks;
+    journal.Apply(cc, blocks);
+    return blocks.Get(i);
+}
+
+} // namespace
+
+TEST(EditJournal_RevertToGeneratedDropsDelta)
+{
+    EditJournal journal;
+    ChunkCoord cc{ 3, -2, 7 };
+
+    journal.Set(cc, 100, Block::Stone, false);
+    journal.Set(cc, 200, Block::Sand, false);
+    CHECK(journal.EditCount(cc) == 2);
+
+    journal.Set(cc, 100, Block::Air, true);
+    CHECK(journal.EditCount(cc) == 1);
+    CHECK(journal.Has(cc));
+
+    journal.Set(cc, 200, Block::Air, true);
+    CHECK(journal.EditCount(cc) == 0);
+    CHECK(!journal.Has(cc));
+    CHECK(journal.GetStats().chunks == 0);
+}
+
+TEST(EditJournal_SnapshotClearsDeltasAndLaterEditsStay)
+{
+    std::string path = FreshFile("d3tests_journal_snapshot.vjrn");
+    ChunkCoord cc{ 1, 2, 3 };
+    {
+        EditJournal journal;
+        REQUIRE(journal.Open(path, PLANET_KEY));
+        for (int i = 0; i < 10; i++) journal.Set(cc, i, Block::Stone, false);
+        journal.Snapshot(cc, 1);
+        CHECK(journal.EditCount(cc) == 0);
+        CHECK(journal.Has(cc));
+        CHECK(journal.BufferedSnapshots().size() == 1);
+
+        // the snapshot is the base now: a generated value still differs from it
+        journal.Set(cc, 5, Block::Air, true);
+        CHECK(journal.EditCount(cc) == 1);
+        CHECK(Voxel(journal, cc, 5) == Block::Air);
+
+        EditJournal::Stats s = journal.GetStats();
+        CHECK(s.snapshots == 1);
+        CHECK(s.edits == 1);
+        journal.Flush();
+        CHECK(journal.BufferedSnapshots().empty());
+    }
+    // replayed as OpSet: an OpRevert would have dropped the delta
+    EditJournal journal;
+    REQUIRE(journal.Open(path, PLANET_KEY));
+    CHECK(journal.EditCount(cc) == 1);
+    CHECK(Voxel(journal, cc, 5) == Block::Air);
+    CHECK(journal.GetStats().snapshots == 1);
+}
+
+TEST(EditJournal_ReopenReplaysState)
+{
+    std::string path = FreshFile("d3tests_journal_reopen.vjrn");
+    ChunkCoord a{ 0, 0, 0 }, b{ -5, 9, -1 };
+    EditJournal::Stats before;
+    {
+        EditJournal journal;
+        REQUIRE(journal.Open(path, PLANET_KEY));
+        journal.Set(a, 0, Block::Dirt, false);
+        journal.Set(a, CHUNK_VOLUME - 1, Block::Water, false);
+        journal.Set(a, 0, Block::Snow, false);
+        journal.Set(b, 1234, Block::Grass, false);
+        journal.Set(b, 99, Block::Stone, false);
+        journal.Set(b, 99, Block::Air, true);
+        before = journal.GetStats();
+        journal.Close();
+        CHECK(FileBytes(path) == before.fileBytes);
+    }
+    EditJournal journal;
+    REQUIRE(journal.Open(path, PLANET_KEY));
+    EditJournal::Stats after = journal.GetStats();
+    CHECK(after.chunks == before.chunks);
+    CHECK(after.edits == before.edits);
+    CHECK(after.records == before.records);
+    CHECK(after.rewrites == 0);
+    CHECK(journal.EditCount(a) == 2);
+    CHECK(Voxel(journal, a, 0) == Block::Snow);
+    CHECK(Voxel(journal, a, CHUNK_VOLUME - 1) == Block::Water);
+    CHECK(journal.EditCount(b) == 1);
+    CHECK(Voxel(journal, b, 1234) == Block::Grass);
+}
+
+TEST(EditJournal_TornRecordKeepsPrefix)
+{
+    std::string path = FreshFile("d3tests_journal_torn.vjrn");
+    ChunkCoord cc{ 4, 4, 4 };
+    uint64_t goodBytes = 0;
+    {
+        EditJournal journal;
+        REQUIRE(journal.Open(path, PLANET_KEY));
+        for (int i = 0; i < 8; i++) journal.Set(cc, i, Block::Stone, false);
+        journal.Close();
+        goodBytes = FileBytes(path);
+    }
+    AppendBytes(path, 5); // a crash partway through the next record
+
+    EditJournal journal;
+    REQUIRE(journal.Open(path, PLANET_KEY));
+    CHECK(journal.GetStats().rewrites == 1);
+    CHECK(journal.EditCount(cc) == 8);
+    CHECK(Voxel(journal, cc, 7) == Block::Stone);
+    journal.Close();
+    CHECK(FileBytes(path) == goodBytes);
+}
+
+TEST(EditJournal_WrongPlanetKeyStartsOver)
+{
+    std::string path = FreshFile("d3tests_journal_key.vjrn");
+    ChunkCoord cc{ 0, 1, 0 };
+    {
+        EditJournal journal;
+        REQUIRE(journal.Open(path, PLANET_KEY));
+        journal.Set(cc, 10, Block::Sand, false);
+    }
+    EditJournal journal;
+    REQUIRE(journal.Open(path, PLANET_KEY + 1));
+    CHECK(journal.GetStats().rewrites == 1);
+    CHECK(!journal.Has(cc));
+    CHECK(journal.GetStats().chunks == 0);
+
+    // and the replacement is a valid, empty journal for the new key
+    journal.Close();
+    REQUIRE(journal.Open(path, PLANET_KEY + 1));
+    CHECK(journal.GetStats().rewrites == 1);
+    CHECK(journal.GetStats().records == 0);
+}
+
+TEST(EditJournal_OpenCompactsSupersededRecords)
+{
+    std::string path = FreshFile("d3tests_journal_compact.vjrn");
+    ChunkCoord cc{ 2, 0, -2 };
+    uint64_t bigBytes = 0;
+    {
+        EditJournal journal;
+        REQUIRE(journal.Open(path, PLANET_KEY));
+        // one live delta, rewritten often enough to pass 2 * live + 1024
+        for (int i = 0; i < 1100; i++)
+            journal.Set(cc, 42, (i & 1) ? Block::Stone : Block::Dirt, false);
+        CHECK(journal.GetStats().records == 1100);
+        journal.Close();
+        bigBytes = FileBytes(path);
+    }
+    EditJournal journal;
+    REQUIRE(journal.Open(path, PLANET_KEY));
+    EditJournal::Stats s = journal.GetStats();
+    CHECK(s.rewrites == 1);
+    CHECK(s.records == 1);
+    CHECK(s.edits == 1);
+    CHECK(Voxel(journal, cc, 42) == Block::Stone);
+    journal.Close();
+    CHECK(FileBytes(path) < bigBytes);
+    CHECK(FileBytes(path) == s.fileBytes);
+}
@@ -0,0 +1,144 @@
+#include <filesystem>
+#include <random>
+#include <string>
+
+#include "src/voxel/ChunkSummary.h"
+#include "src/voxel/Planet.h"
+#include "src/voxel/RegionStore.h"
+#include "Test.h"
+
+namespace {
+
+std::string FreshDir(const char* name)
+{
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / name;
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+    return dir.string();
+}
+
+// a few KiB once encoded: noise doesn't fit a uniform chunk or a small palette
+void NoisyBlocks(uint32_t seed, BlockStorage& out, ChunkSummary& summary)
+{
+    std::mt19937 rng(seed);
+    ChunkBlocks blocks;
+    for (int i = 0; i < CHUNK_VOLUME; i++) blocks[i] = (Block)(rng() % BLOCK_TYPE_COUNT);
+    out.Assign(blocks);
+    summary = Summarize(blocks);
+}
+
+bool LoadsAs(RegionStore& store, ChunkCoord cc, uint32_t seed)
+{
+    BlockStorage want, got;
+    ChunkSummary wantSummary, gotSummary;
+    NoisyBlocks(seed, want, wantSummary);
+    if (!store.Load(cc, got, gotSummary)) return false;
+    for (int i = 0; i < CHUNK_VOLUME; i++)
+        if (got.Get(i) != want.Get(i)) return false;
+    return gotSummary.opaque == wantSummary.opaque;
+}
+
+uint64_t RegionFileBytes(const std::string& dir)
+{
+    uint64_t total = 0;
+    for (const auto& e : std::filesystem::directory_iterator(dir))
+        if (e.path().extension() == ".vreg") total += e.file_size();
+    return total;
+}
+
+} // namespace
+
+TEST(RegionStore_SaveLoadAcrossReopen)
+{
+    std::string dir = FreshDir("d3tests_region_reopen");
+    PlanetParams pp;
+    {
+        RegionStore store(dir, pp);
+        for (int i = 0; i < 20; i++) {
+            BlockStorage blocks;
+            ChunkSummary summary;
+            NoisyBlocks(i, blocks, summary);
+            store.Save(ChunkCoord{ i - 10, i % 3, -i }, blocks, summary); // several regions
+        }
+        store.Flush();
+    }
+
+    RegionStore store(dir, pp);
+    bool ok = true;
+    for (int i = 0; i < 20; i++) ok &= LoadsAs(store, ChunkCoord{ i - 10, i % 3, -i }, i);
+    CHECK(ok);
+    BlockStorage blocks;
+    ChunkSummary summary;
+    CHECK(!store.Load(ChunkCoord{ 100, 100, 100 }, blocks, summary));
+
+    // other terrain params: the files aren't ours
+    PlanetParams other = pp;
+    other.octaves++;
+    RegionStore foreign(dir, other);
+    CHECK(!foreign.Load(ChunkCoord{ -10, 0, 0 }, blocks, summary));
+}
+
+// Re-saving the same chunks only appends; without compaction the files grow
+// with every save.
+TEST(RegionStore_RewritesCompactDeadPayloads)
+{
+    std::string dir = FreshDir("d3tests_region_compact");
+    PlanetParams pp;
+    constexpr int CHUNKS = 8, ROUNDS = 100;
+
+    uint64_t live = 0;
+    {
+        RegionStore store(dir, pp);
+        for (int round = 0; round < ROUNDS; round++) {
+            for (int c = 0; c < CHUNKS; c++) {
+                BlockStorage blocks;
+                ChunkSummary summary;
+                NoisyBlocks(round * CHUNKS + c, blocks, summary);
+                store.Save(ChunkCoord{ c, 0, 0 }, blocks, summary);
+            }
+            store.Flush();
+            // readers stay correct across compactions
+            if (round % 10 == 9) {
+                bool ok = true;
+                for (int c = 0; c < CHUNKS; c++) ok &= LoadsAs(store, ChunkCoord{ c, 0, 0 }, round * CHUNKS + c);
+                CHECK(ok);
+            }
+        }
+        RegionStore::Stats s = store.GetStats();
+        CHECK(s.compactions > 0);
+        live = s.bytesWritten / ROUNDS; // every round writes the same amount, roughly
+        std::printf("  %llu compactions, %.1f KiB written, %.1f KiB on disk\n",
+            (unsigned long long)s.compactions, s.bytesWritten / 1024.0, RegionFileBytes(dir) / 1024.0);
+    }
+
+    // header + table + live, at most as much dead again plus the slack
+    uint64_t bound = 24 + RegionStore::REGION_CHUNKS * 8 + 2 * live + (256u << 10) + live;
+    CHECK(RegionFileBytes(dir) <= bound);
+
+    RegionStore store(dir, pp);
+    bool ok = true;
+    for (int c = 0; c < CHUNKS; c++) ok &= LoadsAs(store, ChunkCoord{ c, 0, 0 }, (ROUNDS - 1) * CHUNKS + c);
+    CHECK(ok);
+    CHECK(!std::filesystem::exists(dir + "/r.0.0.0.vreg.tmp"));
+}
+
+TEST(RegionStore_WrittenTracksEachChunksOwnSave)
+{
+    std::string dir = FreshDir("d3tests_region_written");
+    PlanetParams pp;
+    RegionStore store(dir, pp);
+
+    BlockStorage blocks;
+    ChunkSummary summary;
+    NoisyBlocks(1, blocks, summary);
+    uint64_t a1 = store.Save(ChunkCoord{ 0, 0, 0 }, blocks, summary);
+    uint64_t a2 = store.Save(ChunkCoord{ 0, 0, 0 }, blocks, summary); // supersedes a1
+    uint64_t b = store.Save(ChunkCoord{ 1, 0, 0 }, blocks, summary);
+    CHECK(a1 < a2 && a2 < b);
+
+    store.Flush();
+    CHECK(store.Written(ChunkCoord{ 0, 0, 0 }, a1));
+    CHECK(store.Written(ChunkCoord{ 0, 0, 0 }, a2));
+    CHECK(store.Written(ChunkCoord{ 1, 0, 0 }, b));
+    CHECK(store.Written(ChunkCoord{ 5, 5, 5 }, 1)); // never saved: nothing to wait for
+}
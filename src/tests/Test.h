@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdio>
+#include <vector>
+
+// Just enough of a test harness for D3Tests: TEST(name) defines and
+// registers a test, CHECK records a failure and keeps going, REQUIRE
+// returns from the test. TestMain runs them all, or those whose name
+// contains argv[1], and exits nonzero if any check failed.
+namespace test {
+
+struct Case {
+    const char* name;
+    void (*fn)();
+};
+
+inline std::vector<Case>& Registry()
+{
+    static std::vector<Case> cases;
+    return cases;
+}
+
+inline int& Failures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+struct Register {
+    Register(const char* name, void (*fn)()) { Registry().push_back({ name, fn }); }
+};
+
+inline bool Check(bool ok, const char* expr, const char* file, int line)
+{
+    if (!ok) {
+        std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", file, line, expr);
+        Failures()++;
+    }
+    return ok;
+}
+
+} // namespace test
+
+#define TEST(name) \
+    static void name(); \
+    static test::Register name##_reg(#name, name); \
+    static void name()
+
+#define CHECK(expr) test::Check(static_cast<bool>(expr), #expr, __FILE__, __LINE__)
+#define REQUIRE(expr) do { if (!CHECK(expr)) return; } while (0)
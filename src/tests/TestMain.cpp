@@ -0,0 +1,21 @@
+#include <cstdio>
+#include <cstring>
+
+#include "Test.h"
+
+int main(int argc, char** argv)
+{
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+
+    int run = 0;
+    for (const test::Case& c : test::Registry()) {
+        if (filter && !std::strstr(c.name, filter)) continue;
+        int before = test::Failures();
+        c.fn();
+        std::printf("%-40s %s\n", c.name, test::Failures() == before ? "ok" : "FAILED");
+        run++;
+    }
+
+    std::printf("%d tests, %d failed checks\n", run, test::Failures());
+    return test::Failures() == 0 ? 0 : 1;
+}
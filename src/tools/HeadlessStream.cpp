@@ -0,0 +1,330 @@
+// Headless streaming driver: runs World::UpdateStreaming + TickBuildQueues
+// along a scripted camera path with no window / GL context and prints
+// throughput + per-stage timings. Used on the perf boxes.
+//
+// The fly phase is paced: each tick sleeps out the rest of --frame-us, so
+// gen/mesh workers see the camera move in real time and the prefetch hit
+// rate means what it would in the app. --unpaced runs ticks back to back
+// for raw throughput; the camera then outruns the workers, so the hit rate
+// is only printed if everything runs inline (--gen-workers 0 --mesh-workers 0).
+//
+//   D3Headless [--rd N] [--ticks N] [--speed V] [--alt H]
+//              [--load-budget US] [--budget US] [--frame-us US] [--horizon SEC]
+//              [--turn D] [--cold-mb N] [--save DIR] [--save-generated]
+//              [--dig R] [--unpaced]
+//              [--gen-workers N] [--mesh-workers N] [--sink null|cpu]
+//              [--mesher greedy|binary|culled] [--noise auto|scalar|sse41|avx2]
+//              [--verbose]
+
+#include <src/voxel/World.h>
+#include <src/mesh/CpuMeshSink.h>
+#include <src/voxel/NoiseBatch.h>
+#include <gtc/matrix_transform.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace {
+
+struct Options {
+    int renderDistance = 5;
+    int flyTicks = 1200;       // 20s at 60Hz
+    int maxLoadTicks = 200000;
+    float speed = 30.0f;       // voxels / second along the path
+    float altitude = 2.5f;     // above terrain (same as App::playerEyeHeight_)
+    float dt = 1.0f / 60.0f;
+
+    // same defaults as App
+    double loadBudgetUs = 24000.0;
+    double playBudgetUs = 3000.0;
+    double targetFrameUs = 1e6 / 60.0; // measured tick time stands in for the frame
+    float horizon = -1.0f;     // prefetch look-ahead, seconds; -1 = World default
+    float turn = 0.0f;         // reverse along the path every D voxels; 0 = never
+    int coldMB = -1;           // cold tier budget; -1 = World default
+    std::string saveDir;       // region store; empty = no persistence
+    bool saveGenerated = false; // region files also keep generated chunks
+    int dig = 0;               // fly phase: dig a ball of radius R under the camera each tick
+    bool paced = true;         // fly phase: sleep each tick out to targetFrameUs
+
+    int genWorkers = -1;       // -1 = World default
+    int meshWorkers = -1;
+    std::string sink = "null";
+    std::string mesher = "greedy";
+    std::string noise = "auto";
+    bool verbose = false;
+};
+
+bool ParseArgs(int argc, char** argv, Options& o)
+{
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        auto next = [&]() -> const char* {
+            if (i + 1 >= argc) { std::fprintf(stderr, "missing value for %s\n", a); std::exit(2); }
+            return argv[++i];
+        };
+
+        if      (!std::strcmp(a, "--rd"))        o.renderDistance = std::atoi(next());
+        else if (!std::strcmp(a, "--ticks"))     o.flyTicks = std::atoi(next());
+        else if (!std::strcmp(a, "--speed"))     o.speed = (float)std::atof(next());
+        else if (!std::strcmp(a, "--alt"))       o.altitude = (float)std::atof(next());
+        else if (!std::strcmp(a, "--load-budget")) o.loadBudgetUs = std::atof(next());
+        else if (!std::strcmp(a, "--budget"))    o.playBudgetUs = std::atof(next());
+        else if (!std::strcmp(a, "--frame-us"))  o.targetFrameUs = std::atof(next());
+        else if (!std::strcmp(a, "--horizon"))   o.horizon = (float)std::atof(next());
+        else if (!std::strcmp(a, "--turn"))      o.turn = (float)std::atof(next());
+        else if (!std::strcmp(a, "--cold-mb"))   o.coldMB = std::atoi(next());
+        else if (!std::strcmp(a, "--save"))      o.saveDir = next();
+        else if (!std::strcmp(a, "--save-generated")) o.saveGenerated = true;
+        else if (!std::strcmp(a, "--dig"))       o.dig = std::atoi(next());
+        else if (!std::strcmp(a, "--unpaced"))   o.paced = false;
+        else if (!std::strcmp(a, "--gen-workers")) o.genWorkers = std::atoi(next());
+        else if (!std::strcmp(a, "--mesh-workers")) o.meshWorkers = std::atoi(next());
+        else if (!std::strcmp(a, "--sink"))      o.sink = next();
+        else if (!std::strcmp(a, "--mesher"))    o.mesher = next();
+        else if (!std::strcmp(a, "--noise"))     o.noise = next();
+        else if (!std::strcmp(a, "--verbose"))   o.verbose = true;
+        else {
+            std::fprintf(stderr, "unknown option %s\n", a);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Great-circle path around the X axis, starting over +Z like App::Run.
+struct CameraPath {
+    const PlanetParams& pp;
+    float altitude;
+
+    glm::vec3 Dir(float arc) const
+    {
+        float a = arc / pp.baseRadius;
+        return glm::vec3(0.0f, std::sin(a), std::cos(a));
+    }
+
+    glm::vec3 Position(float arc) const
+    {
+        glm::vec3 dir = Dir(arc);
+        float surfaceR = pp.baseRadius + HeightOnSphere(dir, pp);
+        float seaR = pp.baseRadius + pp.seaLevelOffset;
+        return dir * (std::max(surfaceR, seaR) + altitude);
+    }
+
+    glm::vec3 Forward(float arc) const
+    {
+        float a = arc / pp.baseRadius;
+        return glm::vec3(0.0f, std::cos(a), -std::sin(a));
+    }
+
+    // same lens as App::Run (45 deg, 2560x1600), looking along the path
+    // (backwards for dir < 0)
+    glm::mat4 ViewProj(float arc, float dir = 1.0f) const
+    {
+        glm::vec3 pos = Position(arc);
+        glm::mat4 projection = glm::perspective(glm::radians(45.0f), 2560.0f / 1600.0f, 0.03f, 2000.0f);
+        glm::mat4 view = glm::lookAt(pos, pos + dir * Forward(arc), Dir(arc));
+        return projection * view;
+    }
+};
+
+// showPrefetch: the camera moved at a speed the workers could keep up with
+void PrintPhase(const char* name, int ticks, double wallSec, const World::BuildStats& s, bool showPrefetch)
+{
+    size_t quads = s.quadsOpaque + s.quadsWater;
+    double w = (wallSec > 0.0) ? wallSec : 1e-9;
+
+    std::printf("[%s] ticks=%d wall=%.3fs\n", name, ticks, wallSec);
+    std::printf("  generated=%zu (%.1f chunks/s)  meshed=%zu (%.1f chunks/s)  unloaded=%zu\n",
+        s.generated, s.generated / w, s.meshed, s.meshed / w, s.unloaded);
+    std::printf("  genCancelled=%zu meshStale=%zu meshSkipped=%zu buried=%zu ocean=%zu\n", s.genCancelled, s.meshStale, s.meshSkipped, s.buried, s.ocean);
+    std::printf("  overBudget=%zu ticks (%.1f%%) restored=%zu fromDisk=%zu saved=%zu\n",
+        s.overBudget, ticks ? 100.0 * s.overBudget / ticks : 0.0, s.restored, s.loadedFromDisk, s.saved);
+    if (s.edits || s.editsApplied)
+        std::printf("  edits=%zu applied=%zu snapshots=%zu\n", s.edits, s.editsApplied, s.snapshots);
+    size_t entered = s.prefetchHits + s.prefetchMisses;
+    if (entered && showPrefetch)
+        std::printf("  prefetch: %zu requested ahead, %zu/%zu entered the render cube ready (%.1f%% hit)\n",
+            s.prefetched, s.prefetchHits, entered, 100.0 * s.prefetchHits / entered);
+    std::printf("  quads=%zu opaque=%zu water=%zu (%.0f quads/s, %.1f KiB)\n",
+        quads, s.quadsOpaque, s.quadsWater, quads / w, quads * sizeof(PackedQuad) / 1024.0);
+
+    auto stage = [](const char* label, double sec, size_t items) {
+        double avgUs = items ? (sec * 1e6 / (double)items) : 0.0;
+        std::printf("  %-8s %9.2f ms total  %8.1f us/item\n", label, sec * 1e3, avgUs);
+    };
+    stage("stream", s.streamSec, (size_t)ticks);
+    stage("gen", s.genSec, s.generated);
+    stage("disk", s.diskSec, s.loadedFromDisk);
+    stage("mesh", s.meshSec, s.meshed);
+    stage("upload", s.uploadSec, s.meshed);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!ParseArgs(argc, argv, opt)) return 2;
+
+    World world;
+    // keep in sync with App::LoadAssets
+    world.planet.baseRadius = 4096.f;
+    world.planet.maxHeight = 12.0f;
+    world.planet.noiseFreq = 3.0f;
+    world.planet.octaves = 5;
+    world.planet.seaLevelOffset = -2.0f;
+
+    world.SetRenderDistance(opt.renderDistance);
+    world.SetUnloadDistance(std::max(world.GetUnloadDistance(), opt.renderDistance + 3));
+    world.SetStreamLogging(opt.verbose);
+    world.SetTargetFrameTime(opt.targetFrameUs);
+    if (opt.horizon >= 0.0f) world.SetPrefetchHorizon(opt.horizon);
+    if (opt.coldMB >= 0) world.SetColdBudget((size_t)opt.coldMB << 20);
+    world.SetSaveGenerated(opt.saveGenerated);
+    if (!opt.saveDir.empty()) world.OpenRegionStore(opt.saveDir);
+    if (opt.genWorkers >= 0) world.SetGenWorkers(opt.genWorkers);
+    if (opt.meshWorkers >= 0) world.SetMeshWorkers(opt.meshWorkers);
+
+    if      (opt.mesher == "culled") world.SetMesher(MesherKind::FaceCulled);
+    else if (opt.mesher == "binary") world.SetMesher(MesherKind::Binary);
+    else if (opt.mesher != "greedy") {
+        std::fprintf(stderr, "unknown mesher %s (greedy|binary|culled)\n", opt.mesher.c_str());
+        return 2;
+    }
+
+    if      (opt.noise == "scalar") SetNoiseIsa(NoiseIsa::Scalar);
+    else if (opt.noise == "sse41")  SetNoiseIsa(NoiseIsa::SSE41);
+    else if (opt.noise == "avx2")   SetNoiseIsa(NoiseIsa::AVX2);
+    else if (opt.noise != "auto") {
+        std::fprintf(stderr, "unknown noise kernel %s (auto|scalar|sse41|avx2)\n", opt.noise.c_str());
+        return 2;
+    }
+
+    CpuMeshSink* cpuSink = nullptr;
+    if (opt.sink == "cpu") {
+        auto s = std::make_unique<CpuMeshSink>();
+        cpuSink = s.get();
+        world.SetMeshSink(std::move(s));
+    }
+    else if (opt.sink != "null") {
+        std::fprintf(stderr, "unknown sink %s (null|cpu)\n", opt.sink.c_str());
+        return 2;
+    }
+
+    using clock = std::chrono::steady_clock;
+    auto secondsSince = [](clock::time_point t0) {
+        return std::chrono::duration<double>(clock::now() - t0).count();
+    };
+
+    CameraPath path{ world.planet, opt.altitude };
+    float arc = 0.0f;
+
+    std::printf("headless: rd=%d sink=%s mesher=%s noise=%s speed=%.1f ticks=%d genWorkers=%d meshWorkers=%d budget=%.0f/%.0fus\n",
+        opt.renderDistance, opt.sink.c_str(), opt.mesher.c_str(), NoiseIsaName(GetNoiseIsa()), opt.speed, opt.flyTicks,
+        world.GetGenWorkers(), world.GetMeshWorkers(), opt.loadBudgetUs, opt.playBudgetUs);
+
+    // 1) Loading: stand still until the render cube is generated + meshed.
+    world.ResetBuildStats();
+    auto t0 = clock::now();
+    int loadTicks = 0;
+    bool ready = false;
+    for (; loadTicks < opt.maxLoadTicks; loadTicks++) {
+        world.UpdateStreaming(path.Position(arc), path.Forward(arc));
+        world.TickBuildQueues(opt.loadBudgetUs);
+        if (world.IsStreamReady()) { ready = true; loadTicks++; break; }
+    }
+    PrintPhase(ready ? "load" : "load (incomplete)", loadTicks, secondsSince(t0), world.GetBuildStats(), true);
+
+    // 2) Fly the path with play budgets, drawing the opaque pass each tick
+    //    so the frustum cull counts are real.
+    world.ResetBuildStats();
+    t0 = clock::now();
+    size_t drawn = 0, culled = 0;
+    double tickUs = 0.0;
+    float dir = 1.0f, travelled = 0.0f;
+    for (int i = 0; i < opt.flyTicks; i++) {
+        auto tickT0 = clock::now();
+        glm::vec3 from = path.Position(arc);
+        arc += dir * opt.speed * opt.dt;
+        travelled += opt.speed * opt.dt;
+        if (opt.turn > 0.0f && travelled >= opt.turn) { dir = -dir; travelled = 0.0f; }
+        glm::vec3 to = path.Position(arc);
+        world.UpdateStreaming(to, dir * path.Forward(arc), (to - from) / opt.dt);
+        world.TickBuildQueues(opt.playBudgetUs, tickUs);
+        if (opt.dig > 0) {
+            // a tunnel along the path, its top just under the surface
+            glm::ivec3 c = CameraVoxel(to - path.Dir(arc) * (opt.altitude + 1.0f + (float)opt.dig));
+            int r = opt.dig;
+            for (int z = -r; z <= r; z++)
+                for (int y = -r; y <= r; y++)
+                    for (int x = -r; x <= r; x++)
+                        if (x * x + y * y + z * z <= r * r)
+                            world.SetBlock(c.x + x, c.y + y, c.z + z, Block::Air);
+        }
+
+        world.SetViewFrustum(path.ViewProj(arc, dir));
+        world.DrawOpaque();
+        World::StreamStats ds = world.GetStreamStats();
+        drawn += ds.drawnOpaque;
+        culled += ds.culledOpaque;
+
+        if (opt.paced) {
+            // sleep most of the rest, spin the last bit (sleeps overshoot)
+            auto deadline = tickT0 + std::chrono::microseconds((long long)opt.targetFrameUs);
+            while (clock::now() + std::chrono::milliseconds(2) < deadline)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            while (clock::now() < deadline)
+                std::this_thread::yield();
+        }
+        // the whole frame, like App's deltaTime
+        tickUs = secondsSince(tickT0) * 1e6;
+    }
+    bool inlineOnly = opt.genWorkers == 0 && opt.meshWorkers == 0;
+    PrintPhase("fly", opt.flyTicks, secondsSince(t0), world.GetBuildStats(), opt.paced || inlineOnly);
+    if (opt.flyTicks > 0)
+        std::printf("  draw     %.1f chunks/frame drawn, %.1f frustum-culled\n",
+            drawn / (double)opt.flyTicks, culled / (double)opt.flyTicks);
+
+    World::StreamStats st = world.GetStreamStats();
+    std::printf("end: loaded=%zu generated=%zu meshed=%zu genQ=%zu meshQ=%zu uploadQ=%zu distance=%.1f\n",
+        st.loaded, st.generated, st.meshed, st.genQ, st.meshQ, st.uploadQ, arc);
+    std::printf("blocks: %.1f KiB (%.0f B/chunk)  uniform=%zu palette=%zu expanded=%zu\n",
+        st.blockBytes / 1024.0, st.loaded ? st.blockBytes / (double)st.loaded : 0.0,
+        st.uniformChunks, st.paletteChunks, st.expandedChunks);
+    std::printf("chunk pool: %zu live / %zu slots in %zu slabs, high-water %zu, %zu loads reused a slot\n",
+        st.loaded, st.poolCapacity, st.poolSlabs, st.poolHighWater, st.poolReused);
+    std::printf("scheduler: last tick %.0f/%.0f us (scale %.2f) gen=%zu mesh=%zu uploads=%zu; per item gen %.0f us, mesh %.0f us, upload %.1f us\n",
+        st.budgetSpentUs, st.budgetUs, st.budgetScale, st.budgetGen, st.budgetMesh, st.budgetUploads,
+        st.genCostUs, st.meshCostUs, st.uploadCostUs);
+    std::printf("cold tier: %zu chunks, %.1f/%.1f KiB, %zu evicted\n",
+        st.coldChunks, st.coldBytes / 1024.0, st.coldBudget / 1024.0, st.coldEvicted);
+    std::printf("chunk directory: %zu slots, %zu tombstones, %zu rebuilds\n",
+        st.dirCapacity, st.dirTombstones, st.dirRebuilds);
+    HeightTileCache::Stats hc = SurfaceHeights().GetStats();
+    std::printf("height tiles: %zu/%zu resident, %llu filled, %llu hits, %llu evicted\n",
+        hc.tiles, hc.maxTiles, (unsigned long long)hc.misses, (unsigned long long)hc.hits,
+        (unsigned long long)hc.evictions);
+    if (cpuSink)
+        std::printf("cpu sink: meshes=%zu bytes=%zu\n", cpuSink->ResidentMeshes(), cpuSink->ResidentBytes());
+    if (world.HasRegionStore()) {
+        size_t pendingAtEnd = st.regionPending + st.saveQ;
+        t0 = clock::now();
+        world.FlushRegionStore();
+        st = world.GetStreamStats();
+        std::printf("region store: %zu loads, %zu writes (%.1f KiB), %zu compactions; flushed %zu at exit in %.1f ms\n",
+            st.regionLoads, st.regionWrites, st.regionBytes / 1024.0, st.regionCompactions,
+            pendingAtEnd, secondsSince(t0) * 1e3);
+    }
+    if (st.editChunks || st.journalBytes) {
+        std::printf("edit journal: %zu deltas in %zu chunks, %zu snapshots, %.1f KiB on disk\n",
+            st.editDeltas, st.editChunks, st.editSnapshots, st.journalBytes / 1024.0);
+    }
+
+    return 0;
+}
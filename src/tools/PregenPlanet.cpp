@@ -0,0 +1,390 @@
+// Offline pre-generation: bakes every crust chunk in an area into the
+// RegionStore the game opens (World::OpenRegionStore), using all cores, so
+// streaming those chunks only decodes them. Buried, ocean and sky chunks are
+// skipped; the game never generates them anyway. Chunks already in the store
+// (an earlier bake, or edit snapshots) are kept as they are.
+//
+//   D3Pregen [--out DIR] [--center X Y Z] [--radius CHUNKS | --shell]
+//            [--threads N] [--mesh] [--mesher greedy|binary|culled]
+//            [--noise auto|scalar|sse41|avx2]
+//            [--planet-radius R] [--max-height H] [--noise-freq F]
+//            [--octaves N] [--sea-offset S]
+//
+// PlanetParams default to App's; a bake made with other params is ignored
+// by the game (the region files are keyed to them). --mesh also meshes every
+// baked chunk against its baked neighbors, to measure what streaming the
+// area would upload; meshes aren't written.
+
+#include <src/voxel/ChunkGen.h>
+#include <src/voxel/ChunkSummary.h>
+#include <src/voxel/HeightCache.h>
+#include <src/voxel/NoiseBatch.h>
+#include <src/voxel/RegionStore.h>
+#include <src/mesh/ChunkMeshJob.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::string out = "saves/planet"; // where App opens its store
+    glm::vec3 center{ 0.0f };
+    bool hasCenter = false;    // default: the surface over +Z, where App starts
+    int radius = 16;           // chunks
+    bool shell = false;        // the whole crust shell instead of a sphere
+    int threads = 0;           // 0 = every hardware thread
+    bool mesh = false;
+    std::string mesher = "greedy";
+    std::string noise = "auto";
+
+    // same as App::LoadAssets
+    PlanetParams planet;
+};
+
+bool ParseArgs(int argc, char** argv, Options& o)
+{
+    o.planet.baseRadius = 4096.f;
+    o.planet.maxHeight = 12.0f;
+    o.planet.noiseFreq = 3.0f;
+    o.planet.octaves = 5;
+    o.planet.seaLevelOffset = -2.0f;
+
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        auto next = [&]() -> const char* {
+            if (i + 1 >= argc) { std::fprintf(stderr, "missing value for %s\n", a); std::exit(2); }
+            return argv[++i];
+        };
+
+        if      (!std::strcmp(a, "--out"))       o.out = next();
+        else if (!std::strcmp(a, "--center")) {
+            o.center.x = (float)std::atof(next());
+            o.center.y = (float)std::atof(next());
+            o.center.z = (float)std::atof(next());
+            o.hasCenter = true;
+        }
+        else if (!std::strcmp(a, "--radius"))    o.radius = std::atoi(next());
+        else if (!std::strcmp(a, "--shell"))     o.shell = true;
+        else if (!std::strcmp(a, "--threads"))   o.threads = std::atoi(next());
+        else if (!std::strcmp(a, "--mesh"))      o.mesh = true;
+        else if (!std::strcmp(a, "--mesher"))    o.mesher = next();
+        else if (!std::strcmp(a, "--noise"))     o.noise = next();
+        else if (!std::strcmp(a, "--planet-radius")) o.planet.baseRadius = (float)std::atof(next());
+        else if (!std::strcmp(a, "--max-height")) o.planet.maxHeight = (float)std::atof(next());
+        else if (!std::strcmp(a, "--noise-freq")) o.planet.noiseFreq = (float)std::atof(next());
+        else if (!std::strcmp(a, "--octaves"))   o.planet.octaves = std::atoi(next());
+        else if (!std::strcmp(a, "--sea-offset")) o.planet.seaLevelOffset = (float)std::atof(next());
+        else {
+            std::fprintf(stderr, "unknown option %s\n", a);
+            return false;
+        }
+    }
+    return true;
+}
+
+using Clock = std::chrono::steady_clock;
+
+double SecondsSince(Clock::time_point t0)
+{
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+int FloorDivChunk(float v)
+{
+    return (int)std::floor(v / (float)CHUNK_SIZE);
+}
+
+// What one worker did in one stage; busy is the sum of the timed parts.
+struct ThreadStats {
+    size_t items = 0;
+    size_t skipped = 0;   // gen: already in the store
+    double workSec = 0.0; // classify / generate / mesh
+    double saveSec = 0.0; // gen: RegionStore::Save (summary + encode)
+    double waitSec = 0.0; // gen: I/O thread backlog
+    uint64_t quads = 0;   // mesh
+    uint64_t waterQuads = 0;
+};
+
+// Runs fn(thread, index) for index in [0, n) on `threads` threads, handing
+// out indices in batches of `batch` so neighbors in the list (one region's
+// chunks) stay on one thread.
+template<typename Fn>
+double ParallelFor(int threads, size_t n, size_t batch, Fn&& fn)
+{
+    std::atomic<size_t> nextIndex{ 0 };
+    auto t0 = Clock::now();
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; t++)
+        pool.emplace_back([&, t] {
+            for (;;) {
+                size_t first = nextIndex.fetch_add(batch);
+                if (first >= n) break;
+                size_t last = std::min(n, first + batch);
+                for (size_t i = first; i < last; i++) fn(t, i);
+            }
+        });
+    for (std::thread& th : pool) th.join();
+    return SecondsSince(t0);
+}
+
+void PrintThreads(const std::vector<ThreadStats>& ts, double wallSec, bool gen)
+{
+    double w = (wallSec > 0.0) ? wallSec : 1e-9;
+    for (size_t t = 0; t < ts.size(); t++) {
+        const ThreadStats& s = ts[t];
+        double busy = s.workSec + s.saveSec;
+        std::printf("    thread %2zu: %7zu items  busy %5.1f%%", t, s.items, 100.0 * busy / w);
+        if (gen)
+            std::printf("  (gen %.2fs save %.2fs)  waiting on I/O %.2fs  skipped %zu",
+                s.workSec, s.saveSec, s.waitSec, s.skipped);
+        std::printf("\n");
+    }
+}
+
+double Utilization(const std::vector<ThreadStats>& ts, double wallSec)
+{
+    double busy = 0.0;
+    for (const ThreadStats& s : ts) busy += s.workSec + s.saveSec;
+    return (wallSec > 0.0 && !ts.empty()) ? busy / (wallSec * (double)ts.size()) : 0.0;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!ParseArgs(argc, argv, opt)) return 2;
+    const PlanetParams& pp = opt.planet;
+
+    int threads = opt.threads > 0 ? opt.threads : std::max(1, (int)std::thread::hardware_concurrency());
+
+    MesherKind mesher = MesherKind::Greedy;
+    if      (opt.mesher == "culled") mesher = MesherKind::FaceCulled;
+    else if (opt.mesher == "binary") mesher = MesherKind::Binary;
+    else if (opt.mesher != "greedy") {
+        std::fprintf(stderr, "unknown mesher %s (greedy|binary|culled)\n", opt.mesher.c_str());
+        return 2;
+    }
+
+    if      (opt.noise == "scalar") SetNoiseIsa(NoiseIsa::Scalar);
+    else if (opt.noise == "sse41")  SetNoiseIsa(NoiseIsa::SSE41);
+    else if (opt.noise == "avx2")   SetNoiseIsa(NoiseIsa::AVX2);
+    else if (opt.noise != "auto") {
+        std::fprintf(stderr, "unknown noise kernel %s (auto|scalar|sse41|avx2)\n", opt.noise.c_str());
+        return 2;
+    }
+
+    // Area: a chunk box, plus a sphere test unless it's the whole shell.
+    glm::vec3 center = opt.hasCenter ? opt.center
+        : glm::vec3(0.0f, 0.0f, pp.baseRadius + std::max(HeightOnSphere(glm::vec3(0, 0, 1), pp), pp.seaLevelOffset));
+    glm::ivec3 cc0(FloorDivChunk(center.x), FloorDivChunk(center.y), FloorDivChunk(center.z));
+    int r = std::max(0, opt.radius);
+    glm::ivec3 lo = cc0 - glm::ivec3(r), hi = cc0 + glm::ivec3(r);
+    if (opt.shell) {
+        float rMax = pp.baseRadius + std::max(pp.maxHeight, pp.seaLevelOffset) + 2.0f;
+        lo = glm::ivec3(FloorDivChunk(-rMax));
+        hi = glm::ivec3(FloorDivChunk(rMax));
+    }
+
+    std::printf("pregen: out=%s threads=%d noise=%s mesh=%s\n", opt.out.c_str(), threads,
+        NoiseIsaName(GetNoiseIsa()), opt.mesh ? opt.mesher.c_str() : "no");
+    std::printf("  planet: radius=%.1f maxHeight=%.1f noiseFreq=%.2f octaves=%d seaOffset=%.1f\n",
+        pp.baseRadius, pp.maxHeight, pp.noiseFreq, pp.octaves, pp.seaLevelOffset);
+    if (opt.shell)
+        std::printf("  area: whole crust shell, chunks %d..%d per axis\n", lo.x, hi.x);
+    else
+        std::printf("  area: %d chunks around chunk (%d, %d, %d)\n", r, cc0.x, cc0.y, cc0.z);
+
+    // 1) Classify: which chunks in the area are crust. One x slab per item.
+    int slabs = hi.x - lo.x + 1;
+    std::vector<std::vector<ChunkCoord>> crustBySlab((size_t)slabs);
+    std::vector<ThreadStats> classifyStats((size_t)threads);
+    std::atomic<size_t> shellCounts[4] = {};
+    double classifySec = ParallelFor(threads, (size_t)slabs, 1, [&](int t, size_t i) {
+        auto t0 = Clock::now();
+        int x = lo.x + (int)i;
+        size_t counts[4] = {};
+        for (int y = lo.y; y <= hi.y; y++)
+            for (int z = lo.z; z <= hi.z; z++) {
+                if (!opt.shell) {
+                    glm::ivec3 d = glm::ivec3(x, y, z) - cc0;
+                    if (d.x * d.x + d.y * d.y + d.z * d.z > r * r) continue;
+                }
+                ChunkShell s = ClassifyChunkShell({ x, y, z }, pp);
+                counts[(int)s]++;
+                if (s == ChunkShell::Crust) crustBySlab[i].push_back({ x, y, z });
+            }
+        for (int k = 0; k < 4; k++) shellCounts[k] += counts[k];
+        classifyStats[t].items++;
+        classifyStats[t].workSec += SecondsSince(t0);
+    });
+
+    std::vector<ChunkCoord> crust;
+    for (auto& v : crustBySlab) crust.insert(crust.end(), v.begin(), v.end());
+    crustBySlab.clear();
+    size_t examined = 0;
+    for (auto& c : shellCounts) examined += c;
+
+    // region by region, slot order within one: the I/O thread appends to one
+    // file at a time and the game reads neighbors from the same mapping
+    std::sort(crust.begin(), crust.end(), [](const ChunkCoord& a, const ChunkCoord& b) {
+        int ra[3] = { a.z >> 4, a.y >> 4, a.x >> 4 }, rb[3] = { b.z >> 4, b.y >> 4, b.x >> 4 };
+        for (int k = 0; k < 3; k++) if (ra[k] != rb[k]) return ra[k] < rb[k];
+        if (a.z != b.z) return a.z < b.z;
+        if (a.y != b.y) return a.y < b.y;
+        return a.x < b.x;
+    });
+
+    std::printf("[classify] %zu chunks in %.3fs (%.0f chunks/s): crust=%zu buried=%zu sky=%zu ocean=%zu\n",
+        examined, classifySec, examined / std::max(classifySec, 1e-9), crust.size(),
+        (size_t)shellCounts[(int)ChunkShell::Buried], (size_t)shellCounts[(int)ChunkShell::Sky],
+        (size_t)shellCounts[(int)ChunkShell::Ocean]);
+    std::printf("  utilization %.1f%%\n", 100.0 * Utilization(classifyStats, classifySec));
+
+    // 2) Generate + save. Save only encodes; the store's I/O thread writes,
+    //    and workers wait when it falls behind instead of queueing the
+    //    whole bake in memory.
+    constexpr size_t MAX_PENDING = 4096;
+    RegionStore store(opt.out, pp);
+    std::vector<ThreadStats> genStats((size_t)threads);
+    auto genT0 = Clock::now();
+    double genSec = ParallelFor(threads, crust.size(), 16, [&](int t, size_t i) {
+        ThreadStats& ts = genStats[t];
+        ChunkCoord cc = crust[i];
+
+        auto t0 = Clock::now();
+        BlockStorage blocks;
+        ChunkSummary summary;
+        if (store.Load(cc, blocks, summary)) {
+            ts.skipped++;
+            ts.workSec += SecondsSince(t0);
+            return;
+        }
+
+        ChunkBlocks raw;
+        GenerateChunkBlocks(cc, pp, raw);
+        blocks.Assign(raw);
+        summary = Summarize(raw);
+        auto t1 = Clock::now();
+        ts.workSec += std::chrono::duration<double>(t1 - t0).count();
+
+        while (store.Pending() >= MAX_PENDING)
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        auto t2 = Clock::now();
+        ts.waitSec += std::chrono::duration<double>(t2 - t1).count();
+
+        store.Save(cc, blocks, summary);
+        ts.saveSec += SecondsSince(t2);
+        ts.items++;
+    });
+    auto flushT0 = Clock::now();
+    store.Flush();
+    double flushSec = SecondsSince(flushT0);
+    double bakeSec = SecondsSince(genT0);
+
+    size_t generated = 0, skipped = 0;
+    double genWork = 0.0, saveWork = 0.0;
+    for (const ThreadStats& s : genStats) {
+        generated += s.items;
+        skipped += s.skipped;
+        genWork += s.workSec;
+        saveWork += s.saveSec;
+    }
+    RegionStore::Stats rs = store.GetStats();
+    std::printf("[gen] %zu chunks in %.3fs (%.0f chunks/s), %zu already stored\n",
+        generated, genSec, generated / std::max(genSec, 1e-9), skipped);
+    std::printf("  per chunk: generate %.1f us, save %.1f us (thread time)\n",
+        generated ? genWork * 1e6 / (double)generated : 0.0,
+        generated ? saveWork * 1e6 / (double)generated : 0.0);
+    std::printf("  utilization %.1f%%\n", 100.0 * Utilization(genStats, genSec));
+    PrintThreads(genStats, genSec, true);
+    std::printf("[write] %llu payloads, %.1f MiB (%.1f MiB/s over the bake), %.3fs to drain after gen\n",
+        (unsigned long long)rs.writes, rs.bytesWritten / (1024.0 * 1024.0),
+        rs.bytesWritten / (1024.0 * 1024.0) / std::max(bakeSec, 1e-9), flushSec);
+
+    // 3) Optional: mesh each crust chunk the way streaming would with the
+    //    area loaded. Neighbors come from the store, or are the markers
+    //    World places for buried / ocean chunks; anything else (sky, or
+    //    outside the area) is sampled procedurally by the mesh job, as for a
+    //    neighbor that isn't loaded.
+    if (opt.mesh) {
+        std::vector<ThreadStats> meshStats((size_t)threads);
+        double meshSec = ParallelFor(threads, crust.size(), 16, [&](int t, size_t i) {
+            ThreadStats& ts = meshStats[t];
+            auto t0 = Clock::now();
+
+            auto snap = std::make_unique<MeshSnapshot>();
+            snap->cc = crust[i];
+            snap->pp = pp;
+            snap->mesher = mesher;
+
+            BlockStorage blocks;
+            ChunkSummary summary;
+            if (!store.Load(snap->cc, blocks, summary)) return;
+            if (summary.AllAir()) { ts.items++; ts.workSec += SecondsSince(t0); return; }
+            CopyChunkIntoPadded(blocks, snap->padded);
+            snap->passes = 0;
+            if (summary.HasOpaque()) snap->passes |= MeshPassBit(MeshPass::Opaque);
+            if (summary.HasWater()) snap->passes |= MeshPassBit(MeshPass::Water);
+
+            for (int fi = 0; fi < 6; fi++) {
+                ChunkCoord n{ snap->cc.x, snap->cc.y, snap->cc.z };
+                int axis = fi >> 1, step = (fi & 1) ? -1 : 1; // +X -X +Y -Y +Z -Z
+                (axis == 0 ? n.x : axis == 1 ? n.y : n.z) += step;
+
+                BlockStorage nb;
+                ChunkSummary ns;
+                if (!store.Load(n, nb, ns)) {
+                    ChunkShell s = ClassifyChunkShell(n, pp);
+                    if (s != ChunkShell::Buried && s != ChunkShell::Ocean) continue;
+                    nb.Fill(ShellFill(s));
+                }
+                CopyNeighborFaceIntoPadded(fi, nb, snap->padded);
+                snap->facePresent |= (uint8_t)(1u << fi);
+            }
+
+            ChunkMeshData mesh = BuildChunkMeshFromSnapshot(*snap);
+            ts.quads += mesh.opaque.size() + mesh.water.size();
+            ts.waterQuads += mesh.water.size();
+            ts.items++;
+            ts.workSec += SecondsSince(t0);
+        });
+
+        size_t meshed = 0;
+        uint64_t quads = 0, water = 0;
+        for (const ThreadStats& s : meshStats) { meshed += s.items; quads += s.quads; water += s.waterQuads; }
+        std::printf("[mesh] %zu chunks in %.3fs (%.0f chunks/s), %llu quads (%llu water), %.1f MiB as PackedQuads\n",
+            meshed, meshSec, meshed / std::max(meshSec, 1e-9), (unsigned long long)quads,
+            (unsigned long long)water, quads * sizeof(PackedQuad) / (1024.0 * 1024.0));
+        std::printf("  utilization %.1f%%\n", 100.0 * Utilization(meshStats, meshSec));
+        PrintThreads(meshStats, meshSec, false);
+    }
+
+    // 4) What's on disk now (earlier bakes and dead space from rewrites included)
+    size_t files = 0;
+    uint64_t bytes = 0;
+    std::error_code ec;
+    for (const auto& e : std::filesystem::directory_iterator(opt.out, ec)) {
+        if (e.path().extension() != ".vreg") continue;
+        files++;
+        bytes += e.file_size(ec);
+    }
+    size_t stored = generated + skipped;
+    std::printf("output: %zu region files, %.1f MiB (%.0f B per crust chunk)\n",
+        files, bytes / (1024.0 * 1024.0), stored ? bytes / (double)stored : 0.0);
+    HeightTileCache::Stats hc = SurfaceHeights().GetStats();
+    std::printf("height tiles: %zu/%zu resident, %llu filled, %llu hits, %llu evicted\n",
+        hc.tiles, hc.maxTiles, (unsigned long long)hc.misses, (unsigned long long)hc.hits,
+        (unsigned long long)hc.evictions);
+    return 0;
+}
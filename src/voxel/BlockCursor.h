@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdlib>
+
+#include "World.h"
+
+// Reads blocks the way World::GetBlock does, but remembers the chunk it
+// last read from: staying in it is an array read, stepping into a face
+// neighbor follows Chunk::neighbors, and only longer jumps (or starting
+// outside any loaded chunk) go through the directory. Meant for loops that
+// walk nearby voxels: collision, raycasts, lighting.
+//
+// Main thread only, and not across UpdateStreaming (an unload can free the
+// chunk it points at).
+class BlockCursor {
+public:
+    explicit BlockCursor(const World& world) : world_(world) {}
+
+    Block At(int wx, int wy, int wz)
+    {
+        ChunkCoord cc{ FloorDiv(wx, CHUNK_SIZE), FloorDiv(wy, CHUNK_SIZE), FloorDiv(wz, CHUNK_SIZE) };
+        if (!placed_ || !(cc == cc_)) MoveTo(cc);
+
+        if (chunk_ && chunk_->generated)
+            return chunk_->blocks.Get(Idx(Mod(wx, CHUNK_SIZE), Mod(wy, CHUNK_SIZE), Mod(wz, CHUNK_SIZE)));
+
+        // missing OR not generated yet -> procedural fallback
+        if (!shellKnown_) {
+            shell_ = ClassifyChunkShell(cc_, world_.planet);
+            shellKnown_ = true;
+        }
+        glm::vec3 p = glm::vec3(wx, wy, wz) + glm::vec3(0.5f);
+        return SampleShell(shell_, p, world_.planet);
+    }
+
+    size_t LinkSteps() const { return linkSteps_; }
+    size_t Lookups() const { return lookups_; }
+
+private:
+    void MoveTo(ChunkCoord cc)
+    {
+        int dx = cc.x - cc_.x, dy = cc.y - cc_.y, dz = cc.z - cc_.z;
+        bool oneFace = placed_ && chunk_ && std::abs(dx) + std::abs(dy) + std::abs(dz) == 1;
+        cc_ = cc;
+        placed_ = true;
+        shellKnown_ = false;
+
+        if (oneFace) {
+            // FACES order: +X -X +Y -Y +Z -Z
+            int fi = dx ? (dx > 0 ? 0 : 1) : dy ? (dy > 0 ? 2 : 3) : (dz > 0 ? 4 : 5);
+            chunk_ = world_.Neighbor(*chunk_, fi); // no link = not loaded
+            linkSteps_++;
+            return;
+        }
+        chunk_ = world_.FindChunk(cc);
+        lookups_++;
+    }
+
+    const World& world_;
+    const Chunk* chunk_ = nullptr;
+    ChunkCoord cc_{ 0,0,0 };
+    bool placed_ = false;
+    ChunkShell shell_ = ChunkShell::Crust; // cc_'s, for the fallback
+    bool shellKnown_ = false;
+    size_t linkSteps_ = 0;
+    size_t lookups_ = 0;
+};
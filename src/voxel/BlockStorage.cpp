@@ -0,0 +1,188 @@
+#include "BlockStorage.h"
+
+#include <algorithm>
+#include <cstring>
+
+static_assert(CHUNK_VOLUME % 64 == 0, "packed rows assume whole words per chunk");
+
+namespace {
+
+int BitsForPalette(int n)
+{
+    if (n <= 1) return 0;
+    if (n <= 2) return 1;
+    if (n <= 4) return 2;
+    if (n <= 16) return 4;
+    return 8;
+}
+
+size_t WordCount(int bits) { return (size_t)CHUNK_VOLUME * (size_t)bits / 64; }
+
+} // namespace
+
+void BlockStorage::Fill(Block b)
+{
+    bits_ = 0;
+    paletteSize_ = 1;
+    palette_[0] = b;
+    words_.clear();
+    words_.shrink_to_fit();
+}
+
+void BlockStorage::Assign(const ChunkBlocks& src)
+{
+    // palette in first-seen order
+    int8_t slot[256];
+    std::fill(std::begin(slot), std::end(slot), (int8_t)-1);
+    int n = 0;
+    for (Block b : src) {
+        if (slot[(uint8_t)b] >= 0) continue;
+        if (n < 16) palette_[n] = b;
+        slot[(uint8_t)b] = (int8_t)std::min(n, 16);
+        n++;
+    }
+
+    if (n == 1) { Fill(src[0]); return; }
+
+    int bits = BitsForPalette(n);
+    bits_ = (uint8_t)bits;
+    paletteSize_ = (uint8_t)std::min(n, 16);
+    words_.assign(WordCount(bits), 0);
+    words_.shrink_to_fit();
+
+    for (int i = 0; i < CHUNK_VOLUME; i++) {
+        uint64_t v = (bits == 8) ? (uint64_t)(uint8_t)src[i] : (uint64_t)slot[(uint8_t)src[i]];
+        words_[(size_t)(i * bits) >> 6] |= v << ((i * bits) & 63);
+    }
+}
+
+int BlockStorage::FindPalette(Block b) const
+{
+    for (int k = 0; k < paletteSize_; k++)
+        if (palette_[k] == b) return k;
+    return -1;
+}
+
+void BlockStorage::Repack(int newBits)
+{
+    std::vector<uint64_t> words(WordCount(newBits), 0);
+    for (int i = 0; i < CHUNK_VOLUME; i++) {
+        uint64_t v;
+        if (newBits == 8) {
+            v = (uint64_t)(uint8_t)Get(i);
+        } else if (bits_ == 0) {
+            v = 0;
+        } else {
+            v = (words_[(size_t)(i * bits_) >> 6] >> ((i * bits_) & 63)) & ((1u << bits_) - 1u);
+        }
+        words[(size_t)(i * newBits) >> 6] |= v << ((i * newBits) & 63);
+    }
+    words_ = std::move(words);
+    bits_ = (uint8_t)newBits;
+}
+
+void BlockStorage::Set(int i, Block b)
+{
+    uint32_t v;
+    if (bits_ == 8) {
+        v = (uint8_t)b;
+    } else {
+        int k = FindPalette(b);
+        if (k == 0 && bits_ == 0) return; // uniform, unchanged
+        if (k < 0) {
+            int need = BitsForPalette(paletteSize_ + 1);
+            if (need > bits_) Repack(need);
+            if (bits_ != 8) {
+                palette_[paletteSize_] = b;
+                k = paletteSize_++;
+            }
+        }
+        v = (bits_ == 8) ? (uint32_t)(uint8_t)b : (uint32_t)k;
+    }
+
+    uint64_t& w = words_[(size_t)(i * bits_) >> 6];
+    int shift = (i * bits_) & 63;
+    uint64_t mask = (uint64_t)((1u << bits_) - 1u) << shift;
+    w = (w & ~mask) | ((uint64_t)v << shift);
+}
+
+void BlockStorage::DecodeRows(int first, int n, Block* out) const
+{
+    if (bits_ == 0) {
+        std::fill_n(out, n, palette_[0]);
+        return;
+    }
+    if (bits_ == 8) {
+        // expanded words are the bytes in index order (little-endian)
+        std::memcpy(out, reinterpret_cast<const uint8_t*>(words_.data()) + first, (size_t)n);
+        return;
+    }
+
+    const uint32_t mask = (1u << bits_) - 1u;
+    const int perWord = 64 / bits_;
+    int i = first;
+    while (i < first + n) {
+        uint64_t w = words_[(size_t)(i * bits_) >> 6] >> ((i * bits_) & 63);
+        int take = std::min(perWord - (i % perWord), first + n - i);
+        for (int k = 0; k < take; k++, w >>= bits_)
+            *out++ = palette_[(uint32_t)w & mask];
+        i += take;
+    }
+}
+
+bool BlockStorage::IsAll(Block b) const
+{
+    if (bits_ == 0) return palette_[0] == b;
+
+    // only a non-uniform chunk whose palette still has b after edits can
+    // be all b; Assign never produces one
+    if (bits_ != 8 && FindPalette(b) < 0) return false;
+    for (int i = 0; i < CHUNK_VOLUME; i++)
+        if (Get(i) != b) return false;
+    return true;
+}
+
+void BlockStorage::Write(std::vector<uint8_t>& out) const
+{
+    int palette = bits_ == 8 ? 0 : paletteSize_;
+    size_t at = out.size();
+    out.resize(at + 2 + palette + words_.size() * sizeof(uint64_t));
+
+    uint8_t* p = out.data() + at;
+    *p++ = bits_;
+    *p++ = (uint8_t)palette;
+    for (int i = 0; i < palette; i++) *p++ = (uint8_t)palette_[i];
+    if (!words_.empty())
+        std::memcpy(p, words_.data(), words_.size() * sizeof(uint64_t));
+}
+
+bool BlockStorage::Read(const uint8_t* data, size_t n)
+{
+    if (n < 2) return false;
+    int bits = data[0];
+    int palette = data[1];
+    if (bits != 0 && bits != 1 && bits != 2 && bits != 4 && bits != 8) return false;
+    int maxPalette = bits == 8 ? 0 : (bits == 0 ? 1 : (1 << bits));
+    if (palette > maxPalette || (bits != 8 && palette < 1)) return false;
+
+    size_t words = WordCount(bits);
+    if (n != 2 + (size_t)palette + words * sizeof(uint64_t)) return false;
+
+    const uint8_t* p = data + 2;
+    for (int i = 0; i < palette; i++)
+        if (p[i] > (uint8_t)Block::Water) return false;
+    const uint8_t* packed = p + palette;
+    if (bits == 8)
+        for (size_t i = 0; i < words * sizeof(uint64_t); i++)
+            if (packed[i] > (uint8_t)Block::Water) return false;
+
+    bits_ = (uint8_t)bits;
+    paletteSize_ = (uint8_t)(bits == 8 ? 1 : palette);
+    palette_ = {};
+    for (int i = 0; i < palette; i++) palette_[i] = (Block)p[i];
+    words_.assign(words, 0);
+    words_.shrink_to_fit();
+    if (words)
+        std::memcpy(words_.data(), packed, words * sizeof(uint64_t));
+    return true;
+}
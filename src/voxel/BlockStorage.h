@@ -0,0 +1,72 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Voxel.h"
+
+// chunk dimensions live here so BlockStorage doesn't need Chunk.h
+static constexpr int CHUNK_SIZE = 16;
+static constexpr int CHUNK_VOLUME = CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE;
+
+// one chunk expanded, Idx() order; what generation writes and the mesher reads
+using ChunkBlocks = std::array<Block, CHUNK_VOLUME>;
+
+// A chunk's blocks, stored as compactly as their variety allows:
+//
+//   0 bits  uniform: one block type, no per-voxel data
+//   1/2/4   palette of up to 2/4/16 block types, indices packed in 64-bit
+//           words (a 16-voxel row is always whole words or an aligned part)
+//   8 bits  expanded: the Block values themselves
+//
+// Assign picks the smallest mode for the data; Set promotes as edits add
+// types and never demotes (Assign again to recompact). Index order is Idx().
+class BlockStorage {
+public:
+    BlockStorage() = default;
+    explicit BlockStorage(Block fill) { Fill(fill); }
+
+    void Fill(Block b);
+    void Assign(const ChunkBlocks& src);
+
+    Block Get(int i) const
+    {
+        if (bits_ == 0) return palette_[0];
+        uint64_t w = words_[(size_t)(i * bits_) >> 6];
+        uint32_t v = (uint32_t)(w >> ((i * bits_) & 63)) & ((1u << bits_) - 1u);
+        return bits_ == 8 ? (Block)v : palette_[v];
+    }
+
+    void Set(int i, Block b);
+
+    // out[0..n) = Get(first .. first + n); first and n multiples of 16
+    // (whole rows), which is all the mesher asks for
+    void DecodeRows(int first, int n, Block* out) const;
+    void Decode(ChunkBlocks& out) const { DecodeRows(0, CHUNK_VOLUME, out.data()); }
+
+    bool IsUniform() const { return bits_ == 0; }
+    Block UniformValue() const { return palette_[0]; } // only meaningful if IsUniform
+    bool IsAll(Block b) const;
+
+    int BitsPerBlock() const { return bits_; }
+    int PaletteSize() const { return bits_ == 8 ? 0 : paletteSize_; }
+
+    // heap bytes plus the object itself
+    size_t MemoryBytes() const { return sizeof(*this) + words_.capacity() * sizeof(uint64_t); }
+
+    // The compact form as bytes (mode, palette, packed words; little-endian),
+    // appended to out. Read validates and returns false on anything that
+    // isn't a whole, well-formed encoding of n bytes.
+    void Write(std::vector<uint8_t>& out) const;
+    bool Read(const uint8_t* data, size_t n);
+
+private:
+    int FindPalette(Block b) const;
+    void Repack(int newBits); // keeps contents, changes index width
+
+    uint8_t bits_ = 0;
+    uint8_t paletteSize_ = 1;
+    std::array<Block, 16> palette_{}; // uniform / palette modes; Air by default
+    std::vector<uint64_t> words_;     // CHUNK_VOLUME * bits_ / 64
+};
@@ -0,0 +1,94 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+
+// How much main-thread build work TickBuildQueues does per tick, from a time
+// budget instead of fixed item counts. Each stage's per-item cost is a moving
+// average of what its items actually took, so the counts follow the machine
+// (and the terrain) without tuning.
+//
+// A frame that ran over the target frame time shrinks the budgets that
+// follow; frames under it let them grow back.
+class BuildScheduler {
+public:
+    enum Stage { Gen, Mesh, Upload, Save, STAGE_COUNT };
+
+    // What the last tick decided and spent, for stats.
+    struct Tick {
+        double budgetUs = 0.0;  // after frame-time scaling
+        double spentUs = 0.0;
+        double scale = 1.0;
+        size_t items[STAGE_COUNT] = {};
+        double costUs[STAGE_COUNT] = {}; // moving averages at the start of the tick
+    };
+
+    // 0 = don't adapt to frame time
+    void SetTargetFrame(double us) { targetFrameUs_ = us; }
+    double GetTargetFrame() const { return targetFrameUs_; }
+
+    // lastFrameUs <= 0: unknown (loading screen, first frame), scale kept
+    void Begin(double budgetUs, double lastFrameUs)
+    {
+        if (targetFrameUs_ > 0.0 && lastFrameUs > 0.0) {
+            if (lastFrameUs > targetFrameUs_)
+                scale_ = std::max(MIN_SCALE, scale_ * targetFrameUs_ / lastFrameUs);
+            else
+                scale_ = std::min(1.0, scale_ + RECOVER);
+        }
+
+        tick_ = {};
+        tick_.budgetUs = budgetUs * scale_;
+        tick_.scale = scale_;
+        for (int s = 0; s < STAGE_COUNT; s++) {
+            tick_.costUs[s] = cost_[s];
+            stageUs_[s] = 0.0;
+        }
+    }
+
+    // Share of the budget for stage a when it competes with stage b, in
+    // proportion to the estimated work queued behind each.
+    double Share(Stage a, size_t queuedA, Stage b, size_t queuedB) const
+    {
+        double wa = cost_[a] * (double)queuedA;
+        double wb = cost_[b] * (double)queuedB;
+        if (wa + wb <= 0.0) return tick_.budgetUs;
+        return tick_.budgetUs * wa / (wa + wb);
+    }
+
+    // Whether another item of s fits in the tick, and in stageLimitUs of
+    // stage time. The first item of a stage always fits, so a budget smaller
+    // than one item still makes progress.
+    bool Admit(Stage s, double stageLimitUs) const
+    {
+        if (tick_.items[s] == 0) return true;
+        return stageUs_[s] + cost_[s] <= stageLimitUs &&
+            tick_.spentUs + cost_[s] <= tick_.budgetUs;
+    }
+    bool Admit(Stage s) const { return Admit(s, tick_.budgetUs); }
+
+    // One item of s took us.
+    void Record(Stage s, double us)
+    {
+        tick_.items[s]++;
+        tick_.spentUs += us;
+        stageUs_[s] += us;
+        cost_[s] += (us - cost_[s]) * EMA_ALPHA;
+    }
+
+    bool OverBudget() const { return tick_.spentUs > tick_.budgetUs; }
+    const Tick& LastTick() const { return tick_; }
+    double Cost(Stage s) const { return cost_[s]; }
+
+private:
+    static constexpr double EMA_ALPHA = 0.1;
+    static constexpr double MIN_SCALE = 0.25;
+    static constexpr double RECOVER = 0.05; // per frame under target
+
+    // starting guesses until real items are measured
+    double cost_[STAGE_COUNT] = { 250.0, 150.0, 20.0, 5.0 };
+    double stageUs_[STAGE_COUNT] = {};
+
+    double targetFrameUs_ = 0.0;
+    double scale_ = 1.0;
+    Tick tick_;
+};
@@ -1,29 +1,59 @@
 #pragma once
 #include <array>
+#include <cstdint>
+#include <memory>
 #include <vector>
-#include <glad/glad.h>
 #include <glm.hpp>
 #include "Voxel.h"
-#include "../app/GpuMesh.h"
-
-static constexpr int CHUNK_SIZE = 16;
+#include "MeshSink.h"
+#include "BlockStorage.h"
+#include "ChunkSummary.h"
 
 struct ChunkCoord { int x, y, z; };
 
+inline bool operator==(const ChunkCoord& a, const ChunkCoord& b) {
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+struct GenTicket; // ChunkGen.h
+
+// Refers to one ChunkPool slot for one lifetime of that slot: the generation is
+// bumped on Release, so a handle kept past an unload resolves to nullptr
+// instead of whatever chunk reused the slot.
+struct ChunkHandle {
+    static constexpr uint32_t INVALID = 0xFFFFFFFFu;
+
+    uint32_t index = INVALID;
+    uint32_t gen = 0;
+
+    bool Valid() const { return index != INVALID; }
+};
+
+inline bool operator==(const ChunkHandle& a, const ChunkHandle& b) {
+    return a.index == b.index && a.gen == b.gen;
+}
+
 struct Chunk {
     ChunkCoord coord{};
-    std::array<Block, CHUNK_SIZE* CHUNK_SIZE* CHUNK_SIZE> blocks{};
+    BlockStorage blocks; // uniform / palette / expanded, see BlockStorage.h
+    ChunkSummary summary; // of blocks, set wherever blocks are
 
-    //GLuint vao = 0;
-    //GLuint vbo = 0;
-    //int vertexCount = 0;
-    GpuMesh opaque;
-    GpuMesh water;
+    ChunkMeshSlot mesh; // geometry lives in the World's MeshSink
 
     bool dirty = true;
     bool generated = false;
     bool queuedGen = false;
     bool queuedMesh = false;
+    bool marker = false; // ChunkShell::Buried / Ocean: filled uniform, never generated or meshed
+    bool unsaved = false; // blocks newer than the RegionStore's copy (queued in World::saveQueue)
+    uint32_t meshVersion = 0; // bumped every time a remesh is requested
+    mutable uint32_t lastVisible = 0; // World frame it was last drawn (drawing is const)
+
+    // Loaded face neighbors in FACES order (+X -X +Y -Y +Z -Z), kept by
+    // World::AddChunk / RemoveChunk; invalid = not loaded
+    ChunkHandle neighbors[6];
+
+    std::shared_ptr<GenTicket> genTicket; // set while a gen worker owns this chunk
 };
 
 inline int Idx(int x, int y, int z) {
@@ -0,0 +1,223 @@
+#include "ChunkDirectory.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+namespace {
+
+// Epoch reclamation shared by every directory. A reader publishes the epoch
+// it entered at before loading a table pointer; a retired table is freed
+// once every active reader entered after it was retired.
+constexpr int MAX_READERS = 128;
+constexpr uint64_t IDLE = ~0ull;
+
+std::atomic<uint64_t> gEpoch{ 1 };
+std::atomic<uint64_t> gReaderEpoch[MAX_READERS];
+std::atomic<bool> gReaderUsed[MAX_READERS];
+
+struct ReaderSlot {
+    int index = -1;
+    int depth = 0;
+
+    ReaderSlot()
+    {
+        for (int i = 0; i < MAX_READERS; i++) {
+            bool expected = false;
+            if (gReaderUsed[i].compare_exchange_strong(expected, true)) {
+                gReaderEpoch[i].store(IDLE);
+                index = i;
+                break;
+            }
+        }
+        // a guard that pins nothing would let Rebuild free a table this
+        // thread is walking
+        if (index < 0) {
+            std::cerr << "[ChunkDirectory] more than " << MAX_READERS << " reader threads\n";
+            std::abort();
+        }
+    }
+    ~ReaderSlot()
+    {
+        gReaderEpoch[index].store(IDLE);
+        gReaderUsed[index].store(false);
+    }
+};
+
+ReaderSlot& ThisReader()
+{
+    static thread_local ReaderSlot slot;
+    return slot;
+}
+
+// Lowest epoch any reader is inside, IDLE if none.
+uint64_t OldestReader()
+{
+    uint64_t oldest = IDLE;
+    for (int i = 0; i < MAX_READERS; i++) {
+        if (!gReaderUsed[i].load()) continue;
+        oldest = std::min(oldest, gReaderEpoch[i].load());
+    }
+    return oldest;
+}
+
+} // namespace
+
+ChunkDirectory::ReadGuard::ReadGuard()
+{
+    ReaderSlot& r = ThisReader();
+    outer_ = r.depth++ == 0;
+    if (outer_)
+        gReaderEpoch[r.index].store(gEpoch.load());
+}
+
+ChunkDirectory::ReadGuard::~ReadGuard()
+{
+    ReaderSlot& r = ThisReader();
+    r.depth--;
+    if (outer_)
+        gReaderEpoch[r.index].store(IDLE);
+}
+
+// --- table ---------------------------------------------------------------
+
+ChunkDirectory::ChunkDirectory()
+    : table_(new Table(64))
+{
+}
+
+ChunkDirectory::~ChunkDirectory()
+{
+    delete table_.load();
+    for (Retired& r : retired_) delete r.table;
+}
+
+uint64_t ChunkDirectory::Key(ChunkCoord cc)
+{
+    // 21 bits per axis (+-1M chunks), bit 63 set so no key is EMPTY/TOMBSTONE
+    auto field = [](int v) { return (uint64_t)((uint32_t)(v + (1 << 20)) & 0x1FFFFFu); };
+    return (1ull << 63) | field(cc.x) | (field(cc.y) << 21) | (field(cc.z) << 42);
+}
+
+uint64_t ChunkDirectory::Mix(uint64_t k)
+{
+    // splitmix64 finalizer
+    k ^= k >> 30; k *= 0xbf58476d1ce4e5b9ull;
+    k ^= k >> 27; k *= 0x94d049bb133111ebull;
+    k ^= k >> 31;
+    return k;
+}
+
+ChunkHandle ChunkDirectory::Find(ChunkCoord cc) const
+{
+    // seq_cst, not acquire: it must not be ordered before ReadGuard's epoch
+    // store, or Rebuild could miss this reader and free the table it loads
+    const Table* t = table_.load(std::memory_order_seq_cst);
+    uint64_t key = Key(cc);
+
+    // load factor (live + tombstones) stays <= 1/2, so this terminates
+    for (size_t i = Mix(key) & t->mask;; i = (i + 1) & t->mask) {
+        uint64_t k = t->slots[i].key.load(std::memory_order_acquire);
+        if (k == EMPTY) return ChunkHandle{};
+        if (k == key) {
+            uint64_t v = t->slots[i].value.load(std::memory_order_relaxed);
+            return ChunkHandle{ (uint32_t)v, (uint32_t)(v >> 32) };
+        }
+    }
+}
+
+void ChunkDirectory::Insert(ChunkCoord cc, ChunkHandle h)
+{
+    if (!retired_.empty()) Reclaim();
+
+    Table* t = table_.load(std::memory_order_relaxed);
+    if ((size_ + tombstones_ + 1) * 2 > t->slots.size()) {
+        // grow if mostly live, otherwise same size just to drop tombstones
+        size_t cap = t->slots.size();
+        while ((size_ + 1) * 3 > cap) cap *= 2;
+        Rebuild(cap);
+        t = table_.load(std::memory_order_relaxed);
+    }
+
+    uint64_t key = Key(cc);
+    size_t i = Mix(key) & t->mask;
+    while (t->slots[i].key.load(std::memory_order_relaxed) != EMPTY)
+        i = (i + 1) & t->mask;
+
+    t->slots[i].value.store((uint64_t)h.index | ((uint64_t)h.gen << 32), std::memory_order_relaxed);
+    t->slots[i].key.store(key, std::memory_order_release);
+    size_++;
+}
+
+bool ChunkDirectory::Erase(ChunkCoord cc)
+{
+    Table* t = table_.load(std::memory_order_relaxed);
+    uint64_t key = Key(cc);
+    for (size_t i = Mix(key) & t->mask;; i = (i + 1) & t->mask) {
+        uint64_t k = t->slots[i].key.load(std::memory_order_relaxed);
+        if (k == EMPTY) return false;
+        if (k == key) {
+            t->slots[i].key.store(TOMBSTONE, std::memory_order_release);
+            size_--;
+            tombstones_++;
+            return true;
+        }
+    }
+}
+
+void ChunkDirectory::Clear()
+{
+    size_ = 0;
+    tombstones_ = 0;
+    Rebuild(64);
+}
+
+void ChunkDirectory::Rebuild(size_t capacity)
+{
+    Table* old = table_.load(std::memory_order_relaxed);
+    Table* t = new Table(capacity);
+
+    if (size_ > 0) {
+        for (const Slot& s : old->slots) {
+            uint64_t k = s.key.load(std::memory_order_relaxed);
+            if (k == EMPTY || k == TOMBSTONE) continue;
+
+            size_t i = Mix(k) & t->mask;
+            while (t->slots[i].key.load(std::memory_order_relaxed) != EMPTY)
+                i = (i + 1) & t->mask;
+            t->slots[i].value.store(s.value.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            t->slots[i].key.store(k, std::memory_order_relaxed);
+        }
+    }
+    tombstones_ = 0;
+    rebuilds_++;
+
+    // publish, then retire the old table under a new epoch
+    table_.store(t, std::memory_order_seq_cst);
+    uint64_t e = gEpoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+    retired_.push_back({ old, e });
+    Reclaim();
+}
+
+void ChunkDirectory::Reclaim()
+{
+    uint64_t oldest = OldestReader();
+    retired_.erase(std::remove_if(retired_.begin(), retired_.end(), [&](const Retired& r) {
+        // readers that entered before r.epoch may still hold r.table
+        if (oldest < r.epoch) return false;
+        delete r.table;
+        return true;
+    }), retired_.end());
+}
+
+ChunkDirectory::Stats ChunkDirectory::GetStats() const
+{
+    const Table* t = table_.load(std::memory_order_relaxed);
+    Stats s;
+    s.size = size_;
+    s.capacity = t->slots.size();
+    s.tombstones = tombstones_;
+    s.rebuilds = rebuilds_;
+    s.retiredPending = retired_.size();
+    return s;
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Chunk.h"
+#include "ChunkPool.h"
+
+// Coordinate -> ChunkHandle, as a flat open-addressing table (linear
+// probing) keyed by the packed coordinate, hashed with a 64-bit mixer.
+//
+// One writer, many readers: the owner thread inserts and erases; any thread
+// may look up, wait-free, while holding a ReadGuard. To keep that simple a
+// slot's key only ever goes empty -> key -> tombstone, and its value is
+// written before its key is published, so a reader never sees a key with
+// someone else's value. Tombstones are only cleared by rebuilding into a
+// new table; the old one is retired and freed once no reader can still be
+// walking it (epoch based).
+//
+// The handle a reader gets back may already be stale; ChunkPool's
+// generation check is what catches that.
+class ChunkDirectory {
+public:
+    // Pins the tables a thread can see. Cheap (two atomic stores); hold one
+    // across a batch of lookups on worker threads. The owner thread does
+    // not need one. Up to 128 threads can read; the 129th aborts.
+    class ReadGuard {
+    public:
+        ReadGuard();
+        ~ReadGuard();
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+    private:
+        bool outer_;
+    };
+
+    struct Stats {
+        size_t size = 0;
+        size_t capacity = 0;
+        size_t tombstones = 0;
+        size_t rebuilds = 0;
+        size_t retiredPending = 0; // old tables waiting for readers to leave
+    };
+
+    ChunkDirectory();
+    ~ChunkDirectory();
+    ChunkDirectory(const ChunkDirectory&) = delete;
+    ChunkDirectory& operator=(const ChunkDirectory&) = delete;
+
+    // Owner thread, or any thread holding a ReadGuard.
+    ChunkHandle Find(ChunkCoord cc) const;
+    bool Contains(ChunkCoord cc) const { return Find(cc).Valid(); }
+
+    // Owner thread only. Insert requires cc to be absent.
+    void Insert(ChunkCoord cc, ChunkHandle h);
+    bool Erase(ChunkCoord cc);
+    void Clear();
+
+    size_t Size() const { return size_; }
+    Stats GetStats() const;
+
+private:
+    static constexpr uint64_t EMPTY = 0;
+    static constexpr uint64_t TOMBSTONE = 1;
+
+    struct Slot {
+        std::atomic<uint64_t> key{ EMPTY };
+        std::atomic<uint64_t> value{ 0 }; // ChunkHandle, index | gen << 32
+    };
+
+    struct Table {
+        explicit Table(size_t cap) : mask(cap - 1), slots(cap) {}
+        size_t mask;
+        std::vector<Slot> slots;
+    };
+
+    struct Retired { Table* table; uint64_t epoch; };
+
+    static uint64_t Key(ChunkCoord cc);
+    static uint64_t Mix(uint64_t k);
+
+    void Rebuild(size_t capacity);
+    void Reclaim();
+
+    std::atomic<Table*> table_;
+    size_t size_ = 0;
+    size_t tombstones_ = 0;
+    size_t rebuilds_ = 0;
+    std::vector<Retired> retired_;
+};
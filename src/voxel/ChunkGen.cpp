@@ -0,0 +1,136 @@
+#include "ChunkGen.h"
+#include "NoiseBatch.h"
+#include "RegionStore.h"
+#include <algorithm>
+#include <chrono>
+
+// Same result as SamplePlanetWithOcean per voxel, but batched: surface
+// heights come from the shared tile cache in one Heights call (vertically
+// stacked chunks reuse the same tiles), cave density is one FBMBatch.
+void GenerateChunkBlocks(ChunkCoord cc, const PlanetParams& pp, ChunkBlocks& out)
+{
+    constexpr int N = CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE;
+
+    // ~150 KB, too big for a worker's stack frame
+    struct Scratch {
+        glm::vec3 p[N], dir[N], caveP[N];
+        float d[N], height[N], caveN[N];
+        int caveIdx[N];
+    };
+    static thread_local std::unique_ptr<Scratch> tls;
+    if (!tls) tls = std::make_unique<Scratch>();
+    Scratch& s = *tls;
+
+    for (int z = 0; z < CHUNK_SIZE; z++)
+        for (int y = 0; y < CHUNK_SIZE; y++)
+            for (int x = 0; x < CHUNK_SIZE; x++) {
+                int wx = cc.x * CHUNK_SIZE + x;
+                int wy = cc.y * CHUNK_SIZE + y;
+                int wz = cc.z * CHUNK_SIZE + z;
+
+                int i = Idx(x, y, z);
+                glm::vec3 p = glm::vec3(wx, wy, wz) + glm::vec3(0.5f);
+                float d = glm::length(p);
+                glm::vec3 dir = (d < 1e-5f) ? glm::vec3(0.0f) : p / d;
+
+                s.p[i] = p;
+                s.d[i] = d;
+                s.dir[i] = dir;
+            }
+
+    SurfaceHeights().Heights(s.dir, s.height, N, pp);
+
+    // cave noise only where it can carve
+    int caves = 0;
+    for (int i = 0; i < N; i++) {
+        if (s.d[i] < 1e-5f || !NeedsCaveNoise(s.d[i], s.height[i], pp)) continue;
+        s.caveP[caves] = s.p[i] * CAVE_FREQ;
+        s.caveIdx[caves++] = i;
+    }
+    FBMBatch(s.caveP, s.caveN, (size_t)caves, CAVE_OCTAVES); // packed, caveIdx order
+
+    int k = 0;
+    for (int i = 0; i < N; i++) {
+        float caveN = 0.0f;
+        if (k < caves && s.caveIdx[k] == i) caveN = s.caveN[k++];
+
+        out[i] = (s.d[i] < 1e-5f)
+            ? Block::Stone
+            : PlanetBlockFromNoise(s.dir[i], s.d[i], s.height[i], caveN, pp);
+    }
+}
+
+ChunkShell ClassifyChunkShell(ChunkCoord cc, const PlanetParams& pp)
+{
+    glm::vec3 mn = glm::vec3(cc.x, cc.y, cc.z) * float(CHUNK_SIZE);
+    glm::vec3 mx = mn + glm::vec3(float(CHUNK_SIZE));
+
+    // nearest / farthest point of the box from the planet center
+    float dMin = glm::length(glm::clamp(glm::vec3(0.0f), mn, mx));
+    float dMax = glm::length(glm::max(glm::abs(mn), glm::abs(mx)));
+
+    // FBM stays within [-1,1], so every surface point is inside
+    // baseRadius -/+ maxHeight. One voxel of margin for the mesher's apron.
+    float seaR = pp.baseRadius + pp.seaLevelOffset;
+    float surfaceMin = pp.baseRadius - pp.maxHeight;
+    float topMax = std::max(pp.baseRadius + pp.maxHeight, seaR);
+
+    if (dMin - 1.0f > topMax) return ChunkShell::Sky;
+    if (dMax + 1.0f < surfaceMin) return ChunkShell::Buried;
+
+    // Inside the band: bound the surface under the chunk (apron included)
+    // from the height tiles instead of the global amplitude.
+    glm::vec3 corners[8];
+    for (int k = 0; k < 8; k++)
+        corners[k] = glm::vec3((k & 1) ? mx.x + 1.0f : mn.x - 1.0f,
+                               (k & 2) ? mx.y + 1.0f : mn.y - 1.0f,
+                               (k & 4) ? mx.z + 1.0f : mn.z - 1.0f);
+    float lo, hi;
+    if (!SurfaceHeights().HeightRange(corners, 8, pp, lo, hi)) return ChunkShell::Crust;
+
+    float surfaceMaxR = pp.baseRadius + hi;
+    if (dMin - 1.0f > surfaceMaxR) {
+        if (dMin - 1.0f > seaR) return ChunkShell::Sky;
+        if (dMax + 1.0f < seaR) return ChunkShell::Ocean;
+    }
+    return ChunkShell::Crust;
+}
+
+// --- ChunkGenPool ------------------------------------------------------------
+
+ChunkGenPool::ChunkGenPool(int workers)
+    : pool_(workers, &ChunkGenPool::Run)
+{
+}
+
+std::shared_ptr<GenTicket> ChunkGenPool::Submit(ChunkCoord cc, ChunkHandle handle, const PlanetParams& pp,
+    RegionStore* store)
+{
+    auto ticket = std::make_shared<GenTicket>();
+    pool_.Submit(Job{ cc, handle, pp, ticket, store });
+    return ticket;
+}
+
+bool ChunkGenPool::Run(Job& job, Result& out)
+{
+    using clock = std::chrono::steady_clock;
+
+    if (job.ticket->cancelled.load(std::memory_order_relaxed)) return false;
+
+    auto t0 = clock::now();
+    out.cc = job.cc;
+    out.handle = job.handle;
+    out.ticket = job.ticket;
+    if (job.store && job.store->Load(job.cc, out.blocks, out.summary)) {
+        out.fromDisk = true;
+    } else {
+        ChunkBlocks blocks;
+        GenerateChunkBlocks(job.cc, job.pp, blocks);
+        out.blocks.Assign(blocks);
+        out.summary = Summarize(blocks);
+    }
+    out.sec = std::chrono::duration<double>(clock::now() - t0).count();
+
+    // unloaded while we were working: don't bother handing it back
+    return !job.ticket->cancelled.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "Chunk.h"
+#include "Planet.h"
+#include "JobPool.h"
+#include "ChunkPool.h"
+
+class RegionStore;
+
+// Pure terrain fill for one chunk (what World::FillChunkBlocks does).
+// Safe to call from any thread.
+void GenerateChunkBlocks(ChunkCoord cc, const PlanetParams& pp, ChunkBlocks& out);
+
+// Where a chunk sits against the planet's crust shell: the band between the
+// lowest and highest surface FBM can produce (baseRadius -/+ maxHeight), and
+// inside that band, against the surface actually under it.
+enum class ChunkShell : uint8_t {
+    Crust,  // may hold surface, water or cave openings: generate + mesh
+    Buried, // below the lowest surface; caves stay sealed, nothing shows
+    Sky,    // above the surface under it and the sea: all air
+    Ocean,  // above the surface under it, below the sea: all water
+};
+
+// Radial test from the chunk box's distance to the planet center; chunks in
+// the crust band are refined with the surface's min/max over the box's
+// footprint (HeightTileCache::HeightRange), so most of them never need
+// sampling. Conservative: the apron the mesher reads is included.
+ChunkShell ClassifyChunkShell(ChunkCoord cc, const PlanetParams& pp);
+
+// What a non-Crust chunk holds instead of being generated (sealed caves
+// included: a Buried chunk is solid stone as far as the world is concerned).
+inline Block ShellFill(ChunkShell s)
+{
+    return s == ChunkShell::Buried ? Block::Stone : s == ChunkShell::Ocean ? Block::Water : Block::Air;
+}
+
+// What the voxel at p holds unedited, given its chunk's shell: what
+// GenerateChunkBlocks puts there for a Crust chunk, ShellFill otherwise.
+// The fallback for reads that land on a chunk that isn't generated yet.
+inline Block SampleShell(ChunkShell s, glm::vec3 p, const PlanetParams& pp)
+{
+    return s == ChunkShell::Crust ? SamplePlanetWithOcean(p, pp) : ShellFill(s);
+}
+
+// Cancel by setting the flag; workers check it before and after a job.
+struct GenTicket { std::atomic<bool> cancelled{ false }; };
+
+// Worker threads that run GenerateChunkBlocks into detached buffers.
+// The main thread submits coords, then drains finished results and copies
+// them into the live Chunk. Nothing here touches World.
+class ChunkGenPool {
+public:
+    struct Result {
+        ChunkCoord cc{};
+        ChunkHandle handle;  // the chunk that asked, as it was at Submit
+        std::shared_ptr<GenTicket> ticket;
+        BlockStorage blocks; // compressed on the worker
+        ChunkSummary summary;
+        bool fromDisk = false; // read from the RegionStore instead of generated
+        double sec = 0.0; // worker time spent generating (or loading)
+    };
+
+    explicit ChunkGenPool(int workers);
+
+    // store (optional, must outlive the job) is tried before generating
+    std::shared_ptr<GenTicket> Submit(ChunkCoord cc, ChunkHandle handle, const PlanetParams& pp,
+        RegionStore* store = nullptr);
+
+    size_t Drain(std::vector<std::unique_ptr<Result>>& out) { return pool_.Drain(out); }
+    size_t InFlight() const { return pool_.InFlight(); }
+    int Workers() const { return pool_.Workers(); }
+
+    static int DefaultWorkerCount() { return ::DefaultWorkerCount(); }
+
+private:
+    struct Job {
+        ChunkCoord cc{};
+        ChunkHandle handle;
+        PlanetParams pp;
+        std::shared_ptr<GenTicket> ticket;
+        RegionStore* store = nullptr;
+    };
+
+    static bool Run(Job& job, Result& out);
+
+    JobPool<Job, Result> pool_;
+};
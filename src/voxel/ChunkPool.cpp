@@ -0,0 +1,55 @@
+#include "ChunkPool.h"
+
+#include <algorithm>
+#include <utility>
+
+ChunkHandle ChunkPool::Acquire()
+{
+    acquired_++;
+    if (freeHead_ == ChunkHandle::INVALID) {
+        // new slab, its slots go on the free list in index order
+        uint32_t base = (uint32_t)(slabs_.size() * SLAB_SIZE);
+        slabs_.push_back(std::make_unique<Slot[]>(SLAB_SIZE));
+        Slot* slab = slabs_.back().get();
+        for (uint32_t i = 0; i < SLAB_SIZE; i++)
+            slab[i].nextFree = (i + 1 < SLAB_SIZE) ? base + i + 1 : ChunkHandle::INVALID;
+        freeHead_ = base;
+    } else {
+        reused_++;
+    }
+
+    uint32_t index = freeHead_;
+    Slot& s = *SlotAt(index);
+    freeHead_ = s.nextFree;
+    s.nextFree = ChunkHandle::INVALID;
+    s.live = true;
+
+    live_++;
+    highWater_ = std::max(highWater_, live_);
+    return ChunkHandle{ index, s.gen };
+}
+
+void ChunkPool::Release(ChunkHandle h)
+{
+    Slot* s = SlotAt(h.index);
+    if (!s || !s->live || s->gen != h.gen) return;
+
+    s->chunk = Chunk{};
+    s->live = false;
+    s->gen++;
+    s->nextFree = freeHead_;
+    freeHead_ = h.index;
+    live_--;
+}
+
+ChunkPool::Stats ChunkPool::GetStats() const
+{
+    Stats st;
+    st.live = live_;
+    st.capacity = slabs_.size() * SLAB_SIZE;
+    st.highWater = highWater_;
+    st.slabs = slabs_.size();
+    st.acquired = acquired_;
+    st.reused = reused_;
+    return st;
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Chunk.h"
+
+// Chunks live in fixed-size slabs that are never freed or moved, so loading
+// and unloading recycles slots from a free list instead of going through
+// the allocator, and a Chunk& stays valid until its slot is released.
+// Single-threaded (main thread), like the rest of World's chunk state.
+class ChunkPool {
+public:
+    static constexpr uint32_t SLAB_SIZE = 256; // chunks per slab
+
+    struct Stats {
+        size_t live = 0;      // chunks currently acquired
+        size_t capacity = 0;  // slots across all slabs
+        size_t highWater = 0; // most live at once
+        size_t slabs = 0;
+        size_t acquired = 0;  // total Acquire calls
+        size_t reused = 0;    // ... served from the free list
+    };
+
+    ChunkPool() = default;
+    ChunkPool(const ChunkPool&) = delete;
+    ChunkPool& operator=(const ChunkPool&) = delete;
+
+    // A default-constructed Chunk in a free slot (a new slab if none).
+    ChunkHandle Acquire();
+
+    // Resets the chunk (dropping its block data / ticket) and frees the
+    // slot. The caller releases the mesh first; the pool knows no sink.
+    void Release(ChunkHandle h);
+
+    Chunk* Get(ChunkHandle h)
+    {
+        Slot* s = SlotAt(h.index);
+        return (s && s->live && s->gen == h.gen) ? &s->chunk : nullptr;
+    }
+    const Chunk* Get(ChunkHandle h) const { return const_cast<ChunkPool*>(this)->Get(h); }
+
+    size_t Size() const { return live_; }
+    Stats GetStats() const;
+
+    // Live chunks in slot order. Releasing the current chunk while
+    // iterating is fine; slots never move.
+    template<typename Fn>
+    void ForEach(Fn&& fn)
+    {
+        for (auto& slab : slabs_)
+            for (uint32_t i = 0; i < SLAB_SIZE; i++)
+                if (slab[i].live) fn(slab[i].chunk);
+    }
+    template<typename Fn>
+    void ForEach(Fn&& fn) const
+    {
+        for (auto& slab : slabs_)
+            for (uint32_t i = 0; i < SLAB_SIZE; i++)
+                if (slab[i].live) fn(static_cast<const Chunk&>(slab[i].chunk));
+    }
+
+private:
+    struct Slot {
+        Chunk chunk;
+        uint32_t gen = 0;
+        uint32_t nextFree = ChunkHandle::INVALID;
+        bool live = false;
+    };
+
+    Slot* SlotAt(uint32_t index)
+    {
+        if (index == ChunkHandle::INVALID || index / SLAB_SIZE >= slabs_.size()) return nullptr;
+        return &slabs_[index / SLAB_SIZE][index % SLAB_SIZE];
+    }
+
+    std::vector<std::unique_ptr<Slot[]>> slabs_;
+    uint32_t freeHead_ = ChunkHandle::INVALID;
+    size_t live_ = 0;
+    size_t highWater_ = 0;
+    size_t acquired_ = 0;
+    size_t reused_ = 0;
+};
@@ -0,0 +1,117 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <glm.hpp>
+
+#include "Chunk.h"
+
+// lower score = higher priority: near first, and in front of the camera
+// before behind it. lead is where the camera is headed (chunks, relative to
+// camCC); distance is measured to the segment towards it, so chunks along
+// the way rank as if the camera were already next to them.
+inline float ScoreChunkFrontFirst(const ChunkCoord& cc,
+    const ChunkCoord& camCC,
+    const glm::vec3& camFwdNorm,
+    float frontBias,
+    const glm::vec3& lead = glm::vec3(0.0f))
+{
+    glm::vec3 off = glm::vec3(cc.x - camCC.x, cc.y - camCC.y, cc.z - camCC.z);
+
+    glm::vec3 nearest(0.0f);
+    float lead2 = glm::dot(lead, lead);
+    if (lead2 > 0.0f)
+        nearest = lead * std::clamp(glm::dot(off, lead) / lead2, 0.0f, 1.0f);
+    glm::vec3 toPath = off - nearest;
+
+    float dist2 = glm::dot(toPath, toPath);
+
+    float d = 0.0f;
+    float len = std::sqrt(dist2);
+    if (len > 0.0001f)
+        d = glm::dot(off / len, camFwdNorm); // [-1..1], higher = more in front
+
+    return dist2 - d * frontBias;
+}
+
+// Binary min-heap of chunk coords by ScoreChunkFrontFirst. Entries are
+// scored once on Push against the last SetView; SetView only rescores the
+// whole heap when the camera changed chunk or turned noticeably, so a pop
+// is O(log n) instead of a full rescan.
+//
+// No dedup: World's queuedGen / queuedMesh flags keep coords unique.
+class ChunkQueue {
+public:
+    // Returns true if the heap was rescored. lead: see ScoreChunkFrontFirst.
+    bool SetView(const ChunkCoord& camCC, const glm::vec3& camFwdNorm, float frontBias,
+        const glm::vec3& lead = glm::vec3(0.0f))
+    {
+        glm::vec3 dLead = lead - lead_;
+        bool moved = !(camCC == camCC_) || frontBias != frontBias_ ||
+            glm::dot(camFwdNorm, camFwd_) < RESCORE_COS ||
+            glm::dot(dLead, dLead) > RESCORE_LEAD2;
+        if (!moved) return false;
+
+        camCC_ = camCC;
+        camFwd_ = camFwdNorm;
+        frontBias_ = frontBias;
+        lead_ = lead;
+
+        for (Entry& e : heap_)
+            e.score = Score(e.cc);
+        std::make_heap(heap_.begin(), heap_.end(), Later);
+        return true;
+    }
+
+    void Push(const ChunkCoord& cc)
+    {
+        heap_.push_back({ Score(cc), cc });
+        std::push_heap(heap_.begin(), heap_.end(), Later);
+    }
+
+    bool Pop(ChunkCoord& out)
+    {
+        if (heap_.empty()) return false;
+        std::pop_heap(heap_.begin(), heap_.end(), Later);
+        out = heap_.back().cc;
+        heap_.pop_back();
+        return true;
+    }
+
+    // Drops every coord pred(cc) returns true for. O(n).
+    template<typename Pred>
+    size_t RemoveIf(Pred pred)
+    {
+        size_t before = heap_.size();
+        heap_.erase(std::remove_if(heap_.begin(), heap_.end(),
+            [&](const Entry& e) { return pred(e.cc); }), heap_.end());
+        if (heap_.size() != before)
+            std::make_heap(heap_.begin(), heap_.end(), Later);
+        return before - heap_.size();
+    }
+
+    size_t Size() const { return heap_.size(); }
+    bool Empty() const { return heap_.empty(); }
+
+private:
+    // turning more than ~15 degrees re-sorts the queue
+    static constexpr float RESCORE_COS = 0.966f;
+    // and so does the look-ahead moving by more than half a chunk
+    static constexpr float RESCORE_LEAD2 = 0.25f;
+
+    struct Entry { float score; ChunkCoord cc; };
+
+    // std heap functions build a max-heap; "later" puts the lowest score on top
+    static bool Later(const Entry& a, const Entry& b) { return a.score > b.score; }
+
+    float Score(const ChunkCoord& cc) const
+    {
+        return ScoreChunkFrontFirst(cc, camCC_, camFwd_, frontBias_, lead_);
+    }
+
+    std::vector<Entry> heap_;
+    ChunkCoord camCC_{ 0,0,0 };
+    glm::vec3 camFwd_{ 0,0,-1 };
+    float frontBias_ = 12.0f;
+    glm::vec3 lead_{ 0.0f };
+};
@@ -0,0 +1,72 @@
+#include "ChunkSummary.h"
+
+#include "Chunk.h"
+
+namespace {
+
+// the boundary layer facing FACES[fi] is all opaque; get(i) -> Block
+template<typename GetFn>
+bool LayerOpaque(int fi, GetFn get)
+{
+    int axis = fi >> 1;
+    int u = (axis + 1) % 3, v = (axis + 2) % 3;
+    int p[3];
+    p[axis] = (fi & 1) ? 0 : CHUNK_SIZE - 1;
+
+    for (int j = 0; j < CHUNK_SIZE; j++)
+        for (int i = 0; i < CHUNK_SIZE; i++) {
+            p[u] = i; p[v] = j;
+            if (!IsOpaque(get(Idx(p[0], p[1], p[2])))) return false;
+        }
+    return true;
+}
+
+} // namespace
+
+ChunkSummary Summarize(const ChunkBlocks& blocks)
+{
+    ChunkSummary s;
+    for (Block b : blocks) s.counts[(int)b]++;
+    for (int t = 0; t < BLOCK_TYPE_COUNT; t++)
+        if (IsOpaque((Block)t)) s.opaque += s.counts[t];
+
+    if (s.FullySolid()) { s.opaqueFaces = 0x3F; return s; }
+    if (!s.HasOpaque()) return s;
+
+    for (int fi = 0; fi < 6; fi++)
+        if (LayerOpaque(fi, [&](int i) { return blocks[i]; }))
+            s.opaqueFaces |= (uint8_t)(1u << fi);
+    return s;
+}
+
+void UpdateSummary(ChunkSummary& s, const BlockStorage& blocks, int x, int y, int z, Block was)
+{
+    Block now = blocks.Get(Idx(x, y, z));
+    if (now == was) return;
+
+    s.counts[(int)was]--;
+    s.counts[(int)now]++;
+    bool opaque = IsOpaque(now);
+    if (opaque == IsOpaque(was)) return;
+    opaque ? s.opaque++ : s.opaque--;
+
+    constexpr int L = CHUNK_SIZE - 1;
+    int p[3] = { x, y, z };
+    for (int fi = 0; fi < 6; fi++) {
+        if (p[fi >> 1] != ((fi & 1) ? 0 : L)) continue; // not on this layer
+        uint8_t bit = (uint8_t)(1u << fi);
+        if (!opaque) s.opaqueFaces &= (uint8_t)~bit;
+        else if (LayerOpaque(fi, [&](int i) { return blocks.Get(i); })) s.opaqueFaces |= bit;
+    }
+}
+
+ChunkSummary SummarizeUniform(Block b)
+{
+    ChunkSummary s;
+    s.counts[(int)b] = CHUNK_VOLUME;
+    if (IsOpaque(b)) {
+        s.opaque = CHUNK_VOLUME;
+        s.opaqueFaces = 0x3F;
+    }
+    return s;
+}
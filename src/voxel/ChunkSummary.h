@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdint>
+
+#include "BlockStorage.h"
+
+static constexpr int BLOCK_TYPE_COUNT = (int)Block::Water + 1;
+
+// What a chunk's blocks add up to, computed once when they are filled so
+// streaming and meshing can decide things without rescanning 4096 voxels.
+// Recompute (Summarize) after refilling the blocks, or UpdateSummary after
+// a single-voxel edit.
+struct ChunkSummary {
+    uint16_t counts[BLOCK_TYPE_COUNT] = {}; // voxels per Block value
+    uint16_t opaque = 0;                    // IsOpaque voxels
+
+    // bit fi: the boundary layer facing FACES[fi] (+X -X +Y -Y +Z -Z) is all
+    // opaque, so it hides whatever the neighbor has against it
+    uint8_t opaqueFaces = 0;
+
+    bool AllAir() const { return counts[(int)Block::Air] == CHUNK_VOLUME; }
+    bool HasOpaque() const { return opaque > 0; }
+    bool HasWater() const { return counts[(int)Block::Water] > 0; }
+    bool FullySolid() const { return opaque == CHUNK_VOLUME; }
+};
+
+ChunkSummary Summarize(const ChunkBlocks& blocks);
+ChunkSummary SummarizeUniform(Block b);
+
+// Voxel (x, y, z) of blocks went from was to what blocks holds now: counts
+// and opaque by difference; opaqueFaces rescans only the boundary layers the
+// voxel lies on, and only if its opacity changed.
+void UpdateSummary(ChunkSummary& s, const BlockStorage& blocks, int x, int y, int z, Block was);
@@ -0,0 +1,85 @@
+#include "ColdChunkCache.h"
+
+uint64_t ColdChunkCache::Key(ChunkCoord cc)
+{
+    // same packing as ChunkDirectory: 21 bits per axis
+    auto field = [](int v) { return (uint64_t)((uint32_t)(v + (1 << 20)) & 0x1FFFFFu); };
+    return field(cc.x) | (field(cc.y) << 21) | (field(cc.z) << 42);
+}
+
+size_t ColdChunkCache::EntryBytes(const BlockStorage& blocks)
+{
+    // block data plus the entry, its order node and a rough hash node
+    return blocks.MemoryBytes() + sizeof(Entry) + 2 * sizeof(void*) + 48;
+}
+
+void ColdChunkCache::Put(ChunkCoord cc, BlockStorage&& blocks, const ChunkSummary& summary, uint32_t lastVisible)
+{
+    uint64_t key = Key(cc);
+
+    auto [it, added] = entries_.try_emplace(key);
+    Entry& e = it->second;
+    if (!added) {
+        // stored again without a Take in between: the new blocks win
+        bytes_ -= e.bytes;
+        byVisible_.erase(e.order);
+    }
+    e.blocks = std::move(blocks);
+    e.summary = summary;
+    e.bytes = EntryBytes(e.blocks);
+    e.order = byVisible_.emplace(lastVisible, key);
+
+    bytes_ += e.bytes;
+    stats_.stored++;
+
+    Evict();
+}
+
+bool ColdChunkCache::Take(ChunkCoord cc, BlockStorage& blocks, ChunkSummary& summary)
+{
+    auto it = entries_.find(Key(cc));
+    if (it == entries_.end()) return false;
+
+    Entry& e = it->second;
+    blocks = std::move(e.blocks);
+    summary = e.summary;
+    bytes_ -= e.bytes;
+    byVisible_.erase(e.order);
+    entries_.erase(it);
+    stats_.restored++;
+    return true;
+}
+
+void ColdChunkCache::Evict()
+{
+    while (bytes_ > budget_ && !byVisible_.empty()) {
+        auto oldest = byVisible_.begin();
+        auto it = entries_.find(oldest->second);
+        bytes_ -= it->second.bytes;
+        entries_.erase(it);
+        byVisible_.erase(oldest);
+        stats_.evicted++;
+    }
+}
+
+void ColdChunkCache::SetBudget(size_t bytes)
+{
+    budget_ = bytes;
+    Evict();
+}
+
+ColdChunkCache::Stats ColdChunkCache::GetStats() const
+{
+    Stats s = stats_;
+    s.chunks = entries_.size();
+    s.bytes = bytes_;
+    s.budget = budget_;
+    return s;
+}
+
+void ColdChunkCache::Clear()
+{
+    entries_.clear();
+    byVisible_.clear();
+    bytes_ = 0;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+
+#include "Chunk.h"
+
+// Generated chunks that left the unload cube: their blocks (already palette
+// compressed by BlockStorage) and summary, with no mesh and no pool slot.
+// Coming back in range restores a chunk from here instead of generating it
+// again.
+//
+// Bounded by a byte budget; over it, entries go least recently visible first
+// (Chunk::lastVisible, the last frame the chunk was drawn). Blocks depend only
+// on the coord, the planet params and the EditJournal's deltas (applied again
+// after generating), so an eviction just costs a regen.
+// Single-threaded (main thread), like the rest of World's chunk state.
+class ColdChunkCache {
+public:
+    struct Stats {
+        size_t chunks = 0;
+        size_t bytes = 0;
+        size_t budget = 0;
+        uint64_t stored = 0;
+        uint64_t restored = 0;
+        uint64_t evicted = 0;
+    };
+
+    explicit ColdChunkCache(size_t budgetBytes = 32u << 20) : budget_(budgetBytes) {}
+
+    // Replaces cc's entry if it has one. Evicts down to the budget, which
+    // may drop this entry straight away if it's the least recently visible.
+    void Put(ChunkCoord cc, BlockStorage&& blocks, const ChunkSummary& summary, uint32_t lastVisible);
+
+    // Moves the entry out; false if cc isn't cached.
+    bool Take(ChunkCoord cc, BlockStorage& blocks, ChunkSummary& summary);
+
+    void SetBudget(size_t bytes);
+    size_t GetBudget() const { return budget_; }
+    Stats GetStats() const;
+    void Clear();
+
+private:
+    struct Entry {
+        BlockStorage blocks;
+        ChunkSummary summary;
+        size_t bytes = 0;
+        std::multimap<uint32_t, uint64_t>::iterator order;
+    };
+
+    static uint64_t Key(ChunkCoord cc);
+    static size_t EntryBytes(const BlockStorage& blocks);
+    void Evict();
+
+    std::unordered_map<uint64_t, Entry> entries_;
+    std::multimap<uint32_t, uint64_t> byVisible_; // lastVisible -> key, oldest first
+    size_t bytes_ = 0;
+    size_t budget_;
+    Stats stats_;
+};
@@ -0,0 +1,248 @@
+#include "EditJournal.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+#include "MappedFile.h"
+
+namespace {
+
+// everything on disk is little-endian; so is every target we build for
+void PutU32(uint8_t* p, uint32_t v) { std::memcpy(p, &v, 4); }
+void PutU64(uint8_t* p, uint64_t v) { std::memcpy(p, &v, 8); }
+uint32_t GetU32(const uint8_t* p) { uint32_t v; std::memcpy(&v, p, 4); return v; }
+uint64_t GetU64(const uint8_t* p) { uint64_t v; std::memcpy(&v, p, 8); return v; }
+
+} // namespace
+
+EditJournal::~EditJournal()
+{
+    Close();
+}
+
+uint64_t EditJournal::Key(ChunkCoord cc)
+{
+    // same packing as ChunkDirectory: 21 bits per axis
+    auto field = [](int v) { return (uint64_t)((uint32_t)(v + (1 << 20)) & 0x1FFFFFu); };
+    return field(cc.x) | (field(cc.y) << 21) | (field(cc.z) << 42);
+}
+
+bool EditJournal::Open(const std::string& path, uint64_t planetKey)
+{
+    Close();
+    chunks_.clear();
+    edits_ = 0;
+    snapshots_ = 0;
+    records_ = 0;
+    path_ = path;
+    planetKey_ = planetKey;
+
+    bool clean = false; // the file is ours and every byte of it replayed
+    bool existed = false;
+    {
+        std::unique_ptr<MappedFile> map = MappedFile::Open(path_);
+        existed = map != nullptr;
+        const uint8_t* h = map ? map->Data() : nullptr;
+        if (map && map->Size() >= HEADER_BYTES && std::memcmp(h, "VJRN", 4) == 0 &&
+            GetU32(h + 4) == VERSION && GetU64(h + 8) == planetKey_)
+        {
+            size_t n = (map->Size() - HEADER_BYTES) / RECORD_BYTES;
+            const uint8_t* p = h + HEADER_BYTES;
+            size_t i = 0;
+            for (; i < n; i++, p += RECORD_BYTES) {
+                ChunkCoord cc{ (int)GetU32(p), (int)GetU32(p + 4), (int)GetU32(p + 8) };
+                uint16_t voxel = (uint16_t)(p[12] | (p[13] << 8));
+                uint8_t b = p[14], op = p[15];
+                if (voxel >= CHUNK_VOLUME || b >= BLOCK_TYPE_COUNT || op > OpSnapshot)
+                    break; // corrupt from here on: keep what came before
+                ApplyRecord(cc, voxel, (Block)b, (Op)op);
+            }
+            records_ = i;
+            // a torn last record (crash mid-write) also forces the rewrite
+            clean = i == n && map->Size() == HEADER_BYTES + n * RECORD_BYTES;
+        }
+    } // unmapped before any rewrite replaces the file
+
+    size_t live = edits_ + snapshots_;
+    if (clean && records_ <= 2 * live + 1024) {
+        file_ = std::fopen(path_.c_str(), "ab");
+        if (file_) return true;
+    }
+    if (existed) rewrites_++;
+    return Rewrite();
+}
+
+void EditJournal::Close()
+{
+    if (!file_) return;
+    Flush();
+    std::fclose(file_);
+    file_ = nullptr;
+}
+
+bool EditJournal::Rewrite()
+{
+    if (file_) { std::fclose(file_); file_ = nullptr; }
+    buffer_.clear();
+    snapshotsBuffered_.clear();
+    records_ = 0;
+
+    std::error_code ec;
+    std::filesystem::path final(path_);
+    if (final.has_parent_path()) std::filesystem::create_directories(final.parent_path(), ec);
+    std::string tmp = path_ + ".tmp";
+
+    FILE* f = std::fopen(tmp.c_str(), "wb");
+    if (!f) {
+        std::cerr << "[EditJournal] can't write " << tmp << "\n";
+        return false;
+    }
+
+    uint8_t head[HEADER_BYTES];
+    std::memcpy(head, "VJRN", 4);
+    PutU32(head + 4, VERSION);
+    PutU64(head + 8, planetKey_);
+    bool ok = std::fwrite(head, 1, sizeof(head), f) == sizeof(head);
+
+    // the live state as records, built the same way Append buffers them
+    for (auto& [key, ce] : chunks_) {
+        if (ce.snapshot) Append(ce.cc, 0, Block::Air, OpSnapshot);
+        for (const Edit& e : ce.edits) Append(ce.cc, e.voxel, e.b, OpSet);
+    }
+    ok = ok && (buffer_.empty() || std::fwrite(buffer_.data(), 1, buffer_.size(), f) == buffer_.size());
+    ok = std::fclose(f) == 0 && ok;
+    buffer_.clear();
+
+    // replaces the old file in one step, so a crash leaves one or the other
+    if (ok) std::filesystem::rename(tmp, final, ec);
+    if (!ok || ec) {
+        std::cerr << "[EditJournal] can't write " << path_ << "\n";
+        std::filesystem::remove(tmp, ec);
+        records_ = 0;
+        return false;
+    }
+
+    file_ = std::fopen(path_.c_str(), "ab");
+    return file_ != nullptr;
+}
+
+bool EditJournal::ApplyRecord(ChunkCoord cc, uint16_t voxel, Block b, Op op)
+{
+    uint64_t key = Key(cc);
+    auto it = chunks_.find(key);
+
+    if (op == OpSnapshot) {
+        if (it == chunks_.end()) it = chunks_.emplace(key, ChunkEdits{ cc, {}, false }).first;
+        ChunkEdits& ce = it->second;
+        edits_ -= ce.edits.size();
+        ce.edits.clear();
+        if (!ce.snapshot) snapshots_++;
+        ce.snapshot = true;
+        return true;
+    }
+
+    auto at = [&](ChunkEdits& ce) {
+        return std::lower_bound(ce.edits.begin(), ce.edits.end(), voxel,
+            [](const Edit& e, uint16_t v) { return e.voxel < v; });
+    };
+
+    if (op == OpRevert) {
+        if (it == chunks_.end()) return false;
+        ChunkEdits& ce = it->second;
+        auto e = at(ce);
+        if (e == ce.edits.end() || e->voxel != voxel) return false;
+        ce.edits.erase(e);
+        edits_--;
+        if (ce.edits.empty() && !ce.snapshot) chunks_.erase(it);
+        return true;
+    }
+
+    if (it == chunks_.end()) it = chunks_.emplace(key, ChunkEdits{ cc, {}, false }).first;
+    ChunkEdits& ce = it->second;
+    auto e = at(ce);
+    if (e != ce.edits.end() && e->voxel == voxel) {
+        if (e->b == b) return false;
+        e->b = b;
+        return true;
+    }
+    ce.edits.insert(e, Edit{ voxel, b });
+    edits_++;
+    return true;
+}
+
+void EditJournal::Append(ChunkCoord cc, uint16_t voxel, Block b, Op op)
+{
+    uint8_t r[RECORD_BYTES];
+    PutU32(r, (uint32_t)cc.x);
+    PutU32(r + 4, (uint32_t)cc.y);
+    PutU32(r + 8, (uint32_t)cc.z);
+    r[12] = (uint8_t)(voxel & 0xFF);
+    r[13] = (uint8_t)(voxel >> 8);
+    r[14] = (uint8_t)b;
+    r[15] = (uint8_t)op;
+    buffer_.insert(buffer_.end(), r, r + RECORD_BYTES);
+    records_++;
+}
+
+void EditJournal::Set(ChunkCoord cc, int i, Block b, bool generated)
+{
+    auto it = chunks_.find(Key(cc));
+    bool snapshot = it != chunks_.end() && it->second.snapshot;
+    Op op = (generated && !snapshot) ? OpRevert : OpSet;
+
+    if (ApplyRecord(cc, (uint16_t)i, b, op) && file_)
+        Append(cc, (uint16_t)i, b, op);
+}
+
+void EditJournal::Snapshot(ChunkCoord cc, uint64_t ticket)
+{
+    ApplyRecord(cc, 0, Block::Air, OpSnapshot);
+    if (!file_) return;
+    Append(cc, 0, Block::Air, OpSnapshot);
+    snapshotsBuffered_.push_back({ cc, ticket });
+}
+
+bool EditJournal::Has(ChunkCoord cc) const
+{
+    return chunks_.find(Key(cc)) != chunks_.end();
+}
+
+size_t EditJournal::EditCount(ChunkCoord cc) const
+{
+    auto it = chunks_.find(Key(cc));
+    return it == chunks_.end() ? 0 : it->second.edits.size();
+}
+
+size_t EditJournal::Apply(ChunkCoord cc, BlockStorage& blocks) const
+{
+    auto it = chunks_.find(Key(cc));
+    if (it == chunks_.end()) return 0;
+
+    for (const Edit& e : it->second.edits) blocks.Set(e.voxel, e.b);
+    return it->second.edits.size();
+}
+
+void EditJournal::Flush()
+{
+    if (!file_ || buffer_.empty()) return;
+
+    if (std::fwrite(buffer_.data(), 1, buffer_.size(), file_) != buffer_.size() ||
+        std::fflush(file_) != 0)
+        std::cerr << "[EditJournal] write failed: " << path_ << "\n";
+    buffer_.clear();
+    snapshotsBuffered_.clear();
+}
+
+EditJournal::Stats EditJournal::GetStats() const
+{
+    Stats s;
+    s.chunks = chunks_.size();
+    s.edits = edits_;
+    s.snapshots = snapshots_;
+    s.records = records_;
+    s.fileBytes = file_ ? HEADER_BYTES + records_ * RECORD_BYTES : 0;
+    s.rewrites = rewrites_;
+    return s;
+}
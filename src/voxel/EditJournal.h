@@ -0,0 +1,113 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Chunk.h"
+
+// Player edits kept as deltas against procedural generation: per chunk, the
+// voxels that no longer hold what ChunkGen puts there, sorted by Idx(). A
+// chunk that loads is generated (or read from the RegionStore) first and
+// gets its edits written over the top, so what's persisted grows with how
+// much was changed, not with how much was explored.
+//
+// On disk it's an append-only log next to the region files:
+//
+//   header   "VJRN", version, planet key                       (HEADER_BYTES)
+//   records  { i32 x, y, z, u16 voxel, u8 block, u8 op }         (RECORD_BYTES)
+//
+// Open replays the records in order, then rewrites the file from memory if
+// superseded records outnumber live ones. A chunk edited past
+// SNAPSHOT_EDITS is cheaper stored whole: World saves it to the RegionStore
+// and calls Snapshot, which drops its deltas; edits after that are deltas
+// against the snapshot instead of against generation.
+//
+// Records are buffered and only written by Flush, so World can hold a
+// snapshot record back until the region write it refers to has landed;
+// the journal keeps which writes those are (BufferedSnapshots).
+// Main thread only.
+class EditJournal {
+public:
+    static constexpr size_t SNAPSHOT_EDITS = CHUNK_VOLUME / 8;
+
+    // a buffered Snapshot record and the RegionStore::Save ticket it needs
+    struct BufferedSnapshot { ChunkCoord cc; uint64_t ticket; };
+
+    struct Stats {
+        size_t chunks = 0;          // with deltas or a snapshot
+        size_t edits = 0;           // live deltas
+        size_t snapshots = 0;       // chunks whose base is a RegionStore snapshot
+        uint64_t records = 0;       // in the log, written or buffered
+        uint64_t fileBytes = 0;
+        uint64_t rewrites = 0;      // files Open replaced: compacted, torn or not ours
+    };
+
+    EditJournal() = default;
+    ~EditJournal(); // Close
+
+    EditJournal(const EditJournal&) = delete;
+    EditJournal& operator=(const EditJournal&) = delete;
+
+    // Replaces the in-memory deltas with path's, if it's a journal for
+    // planetKey (anything else is replaced), then appends to it. False if
+    // the file can't be written; the journal then stays in memory only.
+    bool Open(const std::string& path, uint64_t planetKey);
+    // Flushes and closes the file; the in-memory deltas stay.
+    void Close();
+
+    // Voxel i of cc now holds b. generated: b is what generation puts there,
+    // so the delta goes away (unless cc has a snapshot to differ from).
+    void Set(ChunkCoord cc, int i, Block b, bool generated);
+    // cc's blocks, edits included, were saved whole to the RegionStore;
+    // ticket is what that Save returned.
+    void Snapshot(ChunkCoord cc, uint64_t ticket);
+
+    bool Has(ChunkCoord cc) const; // deltas or a snapshot: not plain generation
+    size_t EditCount(ChunkCoord cc) const;
+    // Writes cc's deltas into blocks; returns how many there were.
+    size_t Apply(ChunkCoord cc, BlockStorage& blocks) const;
+
+    // Writes buffered records (no-op when not open).
+    void Flush();
+    // Snapshot records waiting for Flush.
+    const std::vector<BufferedSnapshot>& BufferedSnapshots() const { return snapshotsBuffered_; }
+
+    Stats GetStats() const;
+
+private:
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t HEADER_BYTES = 16;
+    static constexpr size_t RECORD_BYTES = 16;
+
+    enum Op : uint8_t { OpSet = 0, OpRevert = 1, OpSnapshot = 2 };
+
+    struct Edit { uint16_t voxel; Block b; };
+    struct ChunkEdits {
+        ChunkCoord cc{};
+        std::vector<Edit> edits; // sorted by voxel
+        bool snapshot = false;
+    };
+
+    static uint64_t Key(ChunkCoord cc);
+
+    // the in-memory half of a record; false if it changes nothing
+    bool ApplyRecord(ChunkCoord cc, uint16_t voxel, Block b, Op op);
+    void Append(ChunkCoord cc, uint16_t voxel, Block b, Op op);
+    // header + the live state, replacing path_; leaves file_ open to append
+    bool Rewrite();
+
+    std::unordered_map<uint64_t, ChunkEdits> chunks_;
+    size_t edits_ = 0;
+    size_t snapshots_ = 0;
+
+    std::string path_;
+    uint64_t planetKey_ = 0;
+    FILE* file_ = nullptr;
+    std::vector<uint8_t> buffer_; // records not written yet
+    std::vector<BufferedSnapshot> snapshotsBuffered_;
+    uint64_t records_ = 0;
+    uint64_t rewrites_ = 0;
+};
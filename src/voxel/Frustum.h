@@ -0,0 +1,40 @@
+#pragma once
+#include <glm.hpp>
+
+// View frustum as 6 planes (ax + by + cz + d >= 0 inside), extracted from a
+// projection * view matrix (Gribb/Hartmann). Planes are not normalized; the
+// box test only needs the sign.
+struct Frustum {
+    glm::vec4 planes[6]{};
+
+    static Frustum FromMatrix(const glm::mat4& viewProj)
+    {
+        // glm is column-major: row i = (m[0][i], m[1][i], m[2][i], m[3][i])
+        auto row = [&](int i) {
+            return glm::vec4(viewProj[0][i], viewProj[1][i], viewProj[2][i], viewProj[3][i]);
+        };
+        glm::vec4 r0 = row(0), r1 = row(1), r2 = row(2), r3 = row(3);
+
+        Frustum f;
+        f.planes[0] = r3 + r0; // left
+        f.planes[1] = r3 - r0; // right
+        f.planes[2] = r3 + r1; // bottom
+        f.planes[3] = r3 - r1; // top
+        f.planes[4] = r3 + r2; // near
+        f.planes[5] = r3 - r2; // far
+        return f;
+    }
+
+    // Conservative: false only if the box is fully outside one plane.
+    bool IntersectsAABB(const glm::vec3& mn, const glm::vec3& mx) const
+    {
+        for (const glm::vec4& p : planes) {
+            // corner furthest along the plane normal
+            glm::vec3 v(p.x >= 0.0f ? mx.x : mn.x,
+                        p.y >= 0.0f ? mx.y : mn.y,
+                        p.z >= 0.0f ? mx.z : mn.z);
+            if (p.x * v.x + p.y * v.y + p.z * v.z + p.w < 0.0f) return false;
+        }
+        return true;
+    }
+};
@@ -0,0 +1,248 @@
+#include "HeightCache.h"
+#include "NoiseBatch.h"
+#include "Planet.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+// Face order matches FACES / ChunkShell users: +X -X +Y -Y +Z -Z.
+// (u, v) are the two other components divided by the major one.
+int CubeFace(const glm::vec3& d, float& u, float& v)
+{
+    float ax = std::abs(d.x), ay = std::abs(d.y), az = std::abs(d.z);
+    if (ax >= ay && ax >= az) {
+        if (ax == 0.0f) { u = v = 0.0f; return 0; }
+        u = d.y / ax; v = d.z / ax;
+        return d.x >= 0.0f ? 0 : 1;
+    }
+    if (ay >= az) {
+        u = d.z / ay; v = d.x / ay;
+        return d.y >= 0.0f ? 2 : 3;
+    }
+    u = d.x / az; v = d.y / az;
+    return d.z >= 0.0f ? 4 : 5;
+}
+
+// inverse of CubeFace (not normalized)
+glm::vec3 CubeFaceDir(int face, float u, float v)
+{
+    float s = (face & 1) ? -1.0f : 1.0f;
+    switch (face >> 1) {
+    case 0:  return glm::vec3(s, u, v);
+    case 1:  return glm::vec3(v, s, u);
+    default: return glm::vec3(u, v, s);
+    }
+}
+
+int CellsPerFace(const PlanetParams& pp)
+{
+    // gnomonic grid: a cell at the face center spans 2R / cells voxels
+    int tiles = std::max(1, (int)std::ceil(2.0f * pp.baseRadius / HeightTileCache::TILE));
+    return tiles * HeightTileCache::TILE;
+}
+
+uint32_t ParamsKey(const PlanetParams& pp)
+{
+    // only what HeightOnSphereExact reads
+    uint32_t w[4];
+    std::memcpy(&w[0], &pp.baseRadius, 4);
+    std::memcpy(&w[1], &pp.maxHeight, 4);
+    std::memcpy(&w[2], &pp.noiseFreq, 4);
+    w[3] = (uint32_t)pp.octaves;
+
+    uint32_t h = 2166136261u;
+    for (uint32_t x : w) h = HashU32((h ^ x) * 16777619u);
+    return h;
+}
+
+uint64_t TileKey(uint32_t params, int face, int tx, int ty)
+{
+    return (uint64_t)params | ((uint64_t)face << 32) | ((uint64_t)tx << 35) | ((uint64_t)ty << 50);
+}
+
+// grid cell + fraction along one face axis
+inline void GridCoord(float u, int cells, int& i, float& f)
+{
+    float g = (u + 1.0f) * 0.5f * (float)cells;
+    i = std::clamp((int)g, 0, cells - 1);
+    f = std::clamp(g - (float)i, 0.0f, 1.0f);
+}
+
+} // namespace
+
+HeightTileCache::TilePtr HeightTileCache::Acquire(uint64_t key, int face, int tx, int ty,
+    int cellsPerFace, const PlanetParams& pp)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = tiles_.find(key);
+        if (it != tiles_.end()) {
+            lru_.splice(lru_.begin(), lru_, it->second.lru);
+            stats_.hits++;
+            return it->second.tile;
+        }
+    }
+
+    // fill without holding the lock; two threads may race on the same tile,
+    // which only wastes one fill
+    constexpr int S = TILE + 1;
+    glm::vec3 pts[S * S];
+    auto tile = std::make_shared<Tile>();
+    float step = 2.0f / (float)cellsPerFace;
+    for (int ly = 0; ly < S; ly++)
+        for (int lx = 0; lx < S; lx++) {
+            float u = (float)(tx * TILE + lx) * step - 1.0f;
+            float v = (float)(ty * TILE + ly) * step - 1.0f;
+            pts[ly * S + lx] = glm::normalize(CubeFaceDir(face, u, v)) * pp.noiseFreq;
+        }
+    FBMBatch(pts, tile->h, S * S, pp.octaves);
+    for (float& h : tile->h) h *= pp.maxHeight;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = tiles_.find(key);
+    if (it != tiles_.end()) {
+        lru_.splice(lru_.begin(), lru_, it->second.lru);
+        return it->second.tile;
+    }
+    lru_.push_front(key);
+    tiles_.emplace(key, Entry{ tile, lru_.begin() });
+    stats_.misses++;
+    EvictLocked();
+    return tile;
+}
+
+void HeightTileCache::EvictLocked()
+{
+    while (tiles_.size() > maxTiles_ && !lru_.empty()) {
+        tiles_.erase(lru_.back());
+        lru_.pop_back();
+        stats_.evictions++;
+    }
+}
+
+void HeightTileCache::Heights(const glm::vec3* dir, float* out, size_t n, const PlanetParams& pp)
+{
+    const int cells = CellsPerFace(pp);
+    const uint32_t params = ParamsKey(pp);
+
+    // A chunk's footprint straddles up to a few tiles and consecutive points
+    // alternate between them; keep the last few so they don't hit the lock.
+    constexpr int HELD = 4;
+    uint64_t heldKey[HELD] = { ~0ull, ~0ull, ~0ull, ~0ull };
+    TilePtr held[HELD];
+    int next = 0;
+
+    for (size_t k = 0; k < n; k++) {
+        float u, v;
+        int face = CubeFace(dir[k], u, v);
+
+        int i, j;
+        float fx, fy;
+        GridCoord(u, cells, i, fx);
+        GridCoord(v, cells, j, fy);
+
+        int tx = i / TILE, ty = j / TILE;
+        uint64_t key = TileKey(params, face, tx, ty);
+        const Tile* cur = nullptr;
+        for (int s = 0; s < HELD; s++)
+            if (heldKey[s] == key) { cur = held[s].get(); break; }
+        if (!cur) {
+            held[next] = Acquire(key, face, tx, ty, cells, pp);
+            heldKey[next] = key;
+            cur = held[next].get();
+            next = (next + 1) % HELD;
+        }
+
+        constexpr int S = TILE + 1;
+        const float* h = cur->h + (j - ty * TILE) * S + (i - tx * TILE);
+        float h0 = h[0] * (1.0f - fx) + h[1] * fx;
+        float h1 = h[S] * (1.0f - fx) + h[S + 1] * fx;
+        out[k] = h0 * (1.0f - fy) + h1 * fy;
+    }
+}
+
+float HeightTileCache::Height(const glm::vec3& dir, const PlanetParams& pp)
+{
+    float h;
+    Heights(&dir, &h, 1, pp);
+    return h;
+}
+
+bool HeightTileCache::HeightRange(const glm::vec3* pts, size_t n, const PlanetParams& pp, float& lo, float& hi)
+{
+    if (n == 0) return false;
+
+    // Gnomonic projection keeps straight lines straight, so a convex set
+    // inside one face pyramid projects to the hull of its corners' (u, v).
+    int face = -1;
+    float u0 = 1.0f, u1 = -1.0f, v0 = 1.0f, v1 = -1.0f;
+    for (size_t k = 0; k < n; k++) {
+        if (pts[k] == glm::vec3(0.0f)) return false;
+        float u, v;
+        int f = CubeFace(pts[k], u, v);
+        if (face >= 0 && f != face) return false;
+        face = f;
+        u0 = std::min(u0, u); u1 = std::max(u1, u);
+        v0 = std::min(v0, v); v1 = std::max(v1, v);
+    }
+
+    const int cells = CellsPerFace(pp);
+    const uint32_t params = ParamsKey(pp);
+    int i0, i1, j0, j1;
+    float f;
+    GridCoord(u0, cells, i0, f);
+    GridCoord(u1, cells, i1, f);
+    GridCoord(v0, cells, j0, f);
+    GridCoord(v1, cells, j1, f);
+
+    // samples i0..i1+1 x j0..j1+1, tile by tile
+    constexpr int S = TILE + 1;
+    lo = std::numeric_limits<float>::max();
+    hi = std::numeric_limits<float>::lowest();
+    for (int ty = j0 / TILE; ty <= j1 / TILE; ty++)
+        for (int tx = i0 / TILE; tx <= i1 / TILE; tx++) {
+            TilePtr t = Acquire(TileKey(params, face, tx, ty), face, tx, ty, cells, pp);
+            int ax = std::max(i0 - tx * TILE, 0), bx = std::min(i1 + 1 - tx * TILE, TILE);
+            int ay = std::max(j0 - ty * TILE, 0), by = std::min(j1 + 1 - ty * TILE, TILE);
+            for (int y = ay; y <= by; y++)
+                for (int x = ax; x <= bx; x++) {
+                    float h = t->h[y * S + x];
+                    lo = std::min(lo, h);
+                    hi = std::max(hi, h);
+                }
+        }
+    return true;
+}
+
+void HeightTileCache::SetMaxTiles(size_t n)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    maxTiles_ = std::max<size_t>(1, n);
+    EvictLocked();
+}
+
+HeightTileCache::Stats HeightTileCache::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats s = stats_;
+    s.tiles = tiles_.size();
+    s.maxTiles = maxTiles_;
+    return s;
+}
+
+void HeightTileCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    tiles_.clear();
+    lru_.clear();
+}
+
+HeightTileCache& SurfaceHeights()
+{
+    static HeightTileCache cache;
+    return cache;
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <glm.hpp>
+
+struct PlanetParams;
+
+// Surface heights on a cube-sphere grid. Each cube face is split into
+// cellsPerFace^2 cells (about one voxel per cell at baseRadius), grouped into
+// TILE x TILE tiles that hold their (TILE+1)^2 corner samples, so a lookup
+// never has to leave its tile. Heights between samples are bilinear.
+//
+// Tiles are filled with FBMBatch on first use and kept in an LRU of at most
+// maxTiles. A tile's contents depend only on its key (params, face, tile
+// x/y), so eviction never changes an answer. Thread-safe; gen workers share
+// one instance.
+class HeightTileCache {
+public:
+    static constexpr int TILE = 32;
+
+    struct Stats {
+        size_t tiles = 0;
+        size_t maxTiles = 0;
+        uint64_t hits = 0;     // tile lookups served from the cache
+        uint64_t misses = 0;   // tiles filled
+        uint64_t evictions = 0;
+    };
+
+    explicit HeightTileCache(size_t maxTiles = 2048) : maxTiles_(maxTiles) {}
+
+    // dir does not need to be normalized; a zero dir reads the +X face center
+    float Height(const glm::vec3& dir, const PlanetParams& pp);
+
+    // out[i] = Height(dir[i]); holds the last few tiles between points, so a
+    // chunk's worth of directions takes the lock a handful of times
+    void Heights(const glm::vec3* dir, float* out, size_t n, const PlanetParams& pp);
+
+    // Bounds of Height() over every direction in the convex hull of pts
+    // (the footprint of a box, seen from the planet center): min/max of the
+    // grid samples under it. False if the points don't all project onto one
+    // cube face; callers then have to assume anything in +-maxHeight.
+    bool HeightRange(const glm::vec3* pts, size_t n, const PlanetParams& pp, float& lo, float& hi);
+
+    void SetMaxTiles(size_t n);
+    Stats GetStats() const;
+    void Clear();
+
+private:
+    struct Tile { float h[(TILE + 1) * (TILE + 1)]; };
+    using TilePtr = std::shared_ptr<const Tile>;
+
+    struct Entry {
+        TilePtr tile;
+        std::list<uint64_t>::iterator lru;
+    };
+
+    // Finds or fills the tile; the fill runs outside the lock.
+    TilePtr Acquire(uint64_t key, int face, int tx, int ty, int cellsPerFace, const PlanetParams& pp);
+    void EvictLocked();
+
+    mutable std::mutex mutex_;
+    std::unordered_map<uint64_t, Entry> tiles_;
+    std::list<uint64_t> lru_; // front = most recently used
+    size_t maxTiles_;
+    Stats stats_;
+};
+
+// Shared by generation, the GetBlock / apron fallbacks and spawn snapping,
+// so they all agree on the surface (HeightOnSphere).
+HeightTileCache& SurfaceHeights();
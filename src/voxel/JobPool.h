@@ -0,0 +1,113 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// leave one core for the render thread
+inline int DefaultWorkerCount()
+{
+    int hw = (int)std::thread::hardware_concurrency();
+    return std::max(1, hw - 1);
+}
+
+// FIFO job queue + worker threads + completion list. The owner submits jobs
+// and periodically drains finished results on its own thread; the pool never
+// calls back into the owner. Used by ChunkGenPool and ChunkMeshPool.
+template<typename Job, typename Result>
+class JobPool {
+public:
+    // Runs on a worker thread. Return false to drop the result (cancelled).
+    using RunFn = std::function<bool(Job&, Result&)>;
+
+    JobPool(int workers, RunFn run) : run_(std::move(run))
+    {
+        workers = std::max(1, workers);
+        threads_.reserve(workers);
+        for (int i = 0; i < workers; i++)
+            threads_.emplace_back([this] { WorkerMain(); });
+    }
+
+    ~JobPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(jobsMutex_);
+            stop_ = true;
+            jobs_.clear(); // abandoned
+        }
+        jobsCv_.notify_all();
+        for (std::thread& t : threads_) t.join();
+    }
+
+    JobPool(const JobPool&) = delete;
+    JobPool& operator=(const JobPool&) = delete;
+
+    void Submit(Job job)
+    {
+        inFlight_.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(jobsMutex_);
+            jobs_.push_back(std::move(job));
+        }
+        jobsCv_.notify_one();
+    }
+
+    // Appends every finished result to out; returns how many were added.
+    size_t Drain(std::vector<std::unique_ptr<Result>>& out)
+    {
+        std::vector<std::unique_ptr<Result>> got;
+        {
+            std::lock_guard<std::mutex> lock(doneMutex_);
+            got.swap(done_);
+        }
+        inFlight_.fetch_sub(got.size(), std::memory_order_relaxed);
+        for (auto& r : got) out.push_back(std::move(r));
+        return got.size();
+    }
+
+    // queued + running + finished-but-not-drained
+    size_t InFlight() const { return inFlight_.load(std::memory_order_relaxed); }
+    int Workers() const { return (int)threads_.size(); }
+
+private:
+    void WorkerMain()
+    {
+        for (;;) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(jobsMutex_);
+                jobsCv_.wait(lock, [this] { return stop_ || !jobs_.empty(); });
+                if (stop_) return;
+                job = std::move(jobs_.front());
+                jobs_.pop_front();
+            }
+
+            auto r = std::make_unique<Result>();
+            if (!run_(job, *r)) {
+                inFlight_.fetch_sub(1, std::memory_order_relaxed);
+                continue;
+            }
+
+            std::lock_guard<std::mutex> lock(doneMutex_);
+            done_.push_back(std::move(r));
+        }
+    }
+
+    RunFn run_;
+
+    std::mutex jobsMutex_;
+    std::condition_variable jobsCv_;
+    std::deque<Job> jobs_;
+    bool stop_ = false;
+
+    std::mutex doneMutex_;
+    std::vector<std::unique_ptr<Result>> done_;
+
+    std::atomic<size_t> inFlight_{ 0 };
+    std::vector<std::thread> threads_;
+};
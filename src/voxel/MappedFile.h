@@ -0,0 +1,33 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Read-only view of a whole file, memory mapped. The file may still be
+// written (appended to) through other handles while mapped; the view covers
+// the size it had at Open, so callers reopen to see anything past that.
+class MappedFile {
+public:
+    // nullptr if the file is missing, empty or can't be mapped
+    static std::unique_ptr<MappedFile> Open(const std::string& path);
+
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* Data() const { return data_; }
+    size_t Size() const { return size_; }
+
+private:
+    MappedFile() = default;
+
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    void* file_ = nullptr;    // HANDLE
+    void* mapping_ = nullptr; // HANDLE
+#else
+    int fd_ = -1;
+#endif
+};
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+
+struct ChunkMeshData;
+
+enum class MeshPass : uint8_t { Opaque, Water };
+
+// Per-chunk handle into whatever MeshSink owns the chunk's geometry.
+// id 0 = nothing stored. Counts are quads (PackedQuad), kept here so World
+// can make draw/skip decisions without asking the sink.
+struct ChunkMeshSlot {
+    uint32_t id = 0;
+    int opaqueCount = 0;
+    int waterCount = 0;
+};
+
+// Where finished chunk meshes go. World never touches GL directly; the app
+// plugs in a GpuMeshSink, headless tools use the CPU or null sink.
+class MeshSink {
+public:
+    virtual ~MeshSink() = default;
+
+    // mesh may be moved-from afterwards
+    virtual void Upload(ChunkMeshSlot& slot, ChunkMeshData& mesh) = 0;
+    virtual void Release(ChunkMeshSlot& slot) = 0;
+
+    // BeginPass, then Draw per visible chunk, then EndPass
+    virtual void BeginPass(MeshPass) const {}
+    virtual void Draw(const ChunkMeshSlot&, MeshPass) const {}
+    virtual void EndPass() const {}
+
+    // Once per presented frame, drawn or not (the loading screen uploads
+    // without drawing); a sink that defers frees past in-flight frames
+    // retires them here.
+    virtual void EndFrame() {}
+};
+
+// Drops the geometry, only keeps the quad counts on the slot.
+class NullMeshSink : public MeshSink {
+public:
+    void Upload(ChunkMeshSlot& slot, ChunkMeshData& mesh) override;
+    void Release(ChunkMeshSlot& slot) override { slot = {}; }
+};
@@ -0,0 +1,287 @@
+#include "NoiseBatch.h"
+#include "Noise.h"
+
+#include <atomic>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define NOISE_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// MSVC compiles intrinsics for any ISA without /arch; GCC/Clang need the
+// per-function target.
+#if defined(NOISE_X86) && (defined(__GNUC__) || defined(__clang__))
+#define NOISE_TARGET(isa) __attribute__((target(isa)))
+#else
+#define NOISE_TARGET(isa)
+#endif
+
+static void FBMBatchScalar(const glm::vec3* p, float* out, size_t n, int octaves)
+{
+    for (size_t i = 0; i < n; i++)
+        out[i] = FBM(p[i], octaves);
+}
+
+#ifdef NOISE_X86
+
+// --- SSE4.1, 4 points -------------------------------------------------------
+
+NOISE_TARGET("sse4.1")
+static inline __m128i HashU32x4(__m128i x)
+{
+    x = _mm_xor_si128(x, _mm_srli_epi32(x, 16)); x = _mm_mullo_epi32(x, _mm_set1_epi32(0x7feb352d));
+    x = _mm_xor_si128(x, _mm_srli_epi32(x, 15)); x = _mm_mullo_epi32(x, _mm_set1_epi32((int)0x846ca68bu));
+    x = _mm_xor_si128(x, _mm_srli_epi32(x, 16));
+    return x;
+}
+
+NOISE_TARGET("sse4.1")
+static inline __m128 Hash3ix4(__m128i x, __m128i y, __m128i z)
+{
+    const __m128i prime = _mm_set1_epi32(16777619);
+    __m128i h = _mm_set1_epi32((int)2166136261u);
+    h = _mm_mullo_epi32(_mm_xor_si128(h, x), prime);
+    h = _mm_mullo_epi32(_mm_xor_si128(h, y), prime);
+    h = _mm_mullo_epi32(_mm_xor_si128(h, z), prime);
+    h = HashU32x4(h);
+    // / 2^24 is exact, same as the scalar division
+    __m128 f = _mm_cvtepi32_ps(_mm_and_si128(h, _mm_set1_epi32(0x00FFFFFF)));
+    return _mm_mul_ps(f, _mm_set1_ps(1.0f / float(0x01000000u)));
+}
+
+NOISE_TARGET("sse4.1")
+static inline __m128 Smoothx4(__m128 t)
+{
+    __m128 k = _mm_sub_ps(_mm_set1_ps(3.0f), _mm_mul_ps(_mm_set1_ps(2.0f), t));
+    return _mm_mul_ps(_mm_mul_ps(t, t), k);
+}
+
+// glm::mix: a * (1 - t) + b * t
+NOISE_TARGET("sse4.1")
+static inline __m128 Mixx4(__m128 a, __m128 b, __m128 t)
+{
+    return _mm_add_ps(_mm_mul_ps(a, _mm_sub_ps(_mm_set1_ps(1.0f), t)), _mm_mul_ps(b, t));
+}
+
+NOISE_TARGET("sse4.1")
+static inline __m128 ValueNoise3x4(__m128 px, __m128 py, __m128 pz)
+{
+    __m128i ix = _mm_cvttps_epi32(_mm_floor_ps(px));
+    __m128i iy = _mm_cvttps_epi32(_mm_floor_ps(py));
+    __m128i iz = _mm_cvttps_epi32(_mm_floor_ps(pz));
+
+    __m128 sx = Smoothx4(_mm_sub_ps(px, _mm_cvtepi32_ps(ix)));
+    __m128 sy = Smoothx4(_mm_sub_ps(py, _mm_cvtepi32_ps(iy)));
+    __m128 sz = Smoothx4(_mm_sub_ps(pz, _mm_cvtepi32_ps(iz)));
+
+    const __m128i one = _mm_set1_epi32(1);
+    __m128i jx = _mm_add_epi32(ix, one), jy = _mm_add_epi32(iy, one), jz = _mm_add_epi32(iz, one);
+
+    __m128 x00 = Mixx4(Hash3ix4(ix, iy, iz), Hash3ix4(jx, iy, iz), sx);
+    __m128 x10 = Mixx4(Hash3ix4(ix, jy, iz), Hash3ix4(jx, jy, iz), sx);
+    __m128 x01 = Mixx4(Hash3ix4(ix, iy, jz), Hash3ix4(jx, iy, jz), sx);
+    __m128 x11 = Mixx4(Hash3ix4(ix, jy, jz), Hash3ix4(jx, jy, jz), sx);
+
+    __m128 y00 = Mixx4(x00, x10, sy);
+    __m128 y01 = Mixx4(x01, x11, sy);
+    return Mixx4(y00, y01, sz);
+}
+
+NOISE_TARGET("sse4.1")
+static void FBMBatchSSE41(const glm::vec3* p, float* out, size_t n, int octaves)
+{
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 px = _mm_setr_ps(p[i].x, p[i + 1].x, p[i + 2].x, p[i + 3].x);
+        __m128 py = _mm_setr_ps(p[i].y, p[i + 1].y, p[i + 2].y, p[i + 3].y);
+        __m128 pz = _mm_setr_ps(p[i].z, p[i + 1].z, p[i + 2].z, p[i + 3].z);
+
+        __m128 sum = _mm_setzero_ps();
+        float amp = 0.5f;
+        float freq = 1.0f;
+        for (int o = 0; o < octaves; o++) {
+            __m128 f = _mm_set1_ps(freq);
+            __m128 v = ValueNoise3x4(_mm_mul_ps(px, f), _mm_mul_ps(py, f), _mm_mul_ps(pz, f));
+            v = _mm_sub_ps(_mm_mul_ps(v, _mm_set1_ps(2.0f)), _mm_set1_ps(1.0f));
+            sum = _mm_add_ps(sum, _mm_mul_ps(v, _mm_set1_ps(amp)));
+            freq *= 2.0f;
+            amp *= 0.5f;
+        }
+        _mm_storeu_ps(out + i, sum);
+    }
+    FBMBatchScalar(p + i, out + i, n - i, octaves);
+}
+
+// --- AVX2, 8 points ---------------------------------------------------------
+
+NOISE_TARGET("avx2")
+static inline __m256i HashU32x8(__m256i x)
+{
+    x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 16)); x = _mm256_mullo_epi32(x, _mm256_set1_epi32(0x7feb352d));
+    x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 15)); x = _mm256_mullo_epi32(x, _mm256_set1_epi32((int)0x846ca68bu));
+    x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+    return x;
+}
+
+NOISE_TARGET("avx2")
+static inline __m256 Hash3ix8(__m256i x, __m256i y, __m256i z)
+{
+    const __m256i prime = _mm256_set1_epi32(16777619);
+    __m256i h = _mm256_set1_epi32((int)2166136261u);
+    h = _mm256_mullo_epi32(_mm256_xor_si256(h, x), prime);
+    h = _mm256_mullo_epi32(_mm256_xor_si256(h, y), prime);
+    h = _mm256_mullo_epi32(_mm256_xor_si256(h, z), prime);
+    h = HashU32x8(h);
+    __m256 f = _mm256_cvtepi32_ps(_mm256_and_si256(h, _mm256_set1_epi32(0x00FFFFFF)));
+    return _mm256_mul_ps(f, _mm256_set1_ps(1.0f / float(0x01000000u)));
+}
+
+NOISE_TARGET("avx2")
+static inline __m256 Smoothx8(__m256 t)
+{
+    __m256 k = _mm256_sub_ps(_mm256_set1_ps(3.0f), _mm256_mul_ps(_mm256_set1_ps(2.0f), t));
+    return _mm256_mul_ps(_mm256_mul_ps(t, t), k);
+}
+
+NOISE_TARGET("avx2")
+static inline __m256 Mixx8(__m256 a, __m256 b, __m256 t)
+{
+    return _mm256_add_ps(_mm256_mul_ps(a, _mm256_sub_ps(_mm256_set1_ps(1.0f), t)), _mm256_mul_ps(b, t));
+}
+
+NOISE_TARGET("avx2")
+static inline __m256 ValueNoise3x8(__m256 px, __m256 py, __m256 pz)
+{
+    __m256i ix = _mm256_cvttps_epi32(_mm256_floor_ps(px));
+    __m256i iy = _mm256_cvttps_epi32(_mm256_floor_ps(py));
+    __m256i iz = _mm256_cvttps_epi32(_mm256_floor_ps(pz));
+
+    __m256 sx = Smoothx8(_mm256_sub_ps(px, _mm256_cvtepi32_ps(ix)));
+    __m256 sy = Smoothx8(_mm256_sub_ps(py, _mm256_cvtepi32_ps(iy)));
+    __m256 sz = Smoothx8(_mm256_sub_ps(pz, _mm256_cvtepi32_ps(iz)));
+
+    const __m256i one = _mm256_set1_epi32(1);
+    __m256i jx = _mm256_add_epi32(ix, one), jy = _mm256_add_epi32(iy, one), jz = _mm256_add_epi32(iz, one);
+
+    __m256 x00 = Mixx8(Hash3ix8(ix, iy, iz), Hash3ix8(jx, iy, iz), sx);
+    __m256 x10 = Mixx8(Hash3ix8(ix, jy, iz), Hash3ix8(jx, jy, iz), sx);
+    __m256 x01 = Mixx8(Hash3ix8(ix, iy, jz), Hash3ix8(jx, iy, jz), sx);
+    __m256 x11 = Mixx8(Hash3ix8(ix, jy, jz), Hash3ix8(jx, jy, jz), sx);
+
+    __m256 y00 = Mixx8(x00, x10, sy);
+    __m256 y01 = Mixx8(x01, x11, sy);
+    return Mixx8(y00, y01, sz);
+}
+
+NOISE_TARGET("avx2")
+static void FBMBatchAVX2(const glm::vec3* p, float* out, size_t n, int octaves)
+{
+    // glm::vec3 is 12 bytes: strided gather of x/y/z
+    const __m256i idx = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const float* base = &p[i].x;
+        __m256 px = _mm256_i32gather_ps(base + 0, idx, 4);
+        __m256 py = _mm256_i32gather_ps(base + 1, idx, 4);
+        __m256 pz = _mm256_i32gather_ps(base + 2, idx, 4);
+
+        __m256 sum = _mm256_setzero_ps();
+        float amp = 0.5f;
+        float freq = 1.0f;
+        for (int o = 0; o < octaves; o++) {
+            __m256 f = _mm256_set1_ps(freq);
+            __m256 v = ValueNoise3x8(_mm256_mul_ps(px, f), _mm256_mul_ps(py, f), _mm256_mul_ps(pz, f));
+            v = _mm256_sub_ps(_mm256_mul_ps(v, _mm256_set1_ps(2.0f)), _mm256_set1_ps(1.0f));
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(v, _mm256_set1_ps(amp)));
+            freq *= 2.0f;
+            amp *= 0.5f;
+        }
+        _mm256_storeu_ps(out + i, sum);
+    }
+    FBMBatchSSE41(p + i, out + i, n - i, octaves);
+}
+
+// --- dispatch ---------------------------------------------------------------
+
+static NoiseIsa DetectNoiseIsa()
+{
+#ifdef _MSC_VER
+    int r[4];
+    __cpuid(r, 0);
+    int maxLeaf = r[0];
+
+    __cpuid(r, 1);
+    bool sse41 = (r[2] & (1 << 19)) != 0;
+    bool osxsave = (r[2] & (1 << 27)) != 0;
+    bool avx = (r[2] & (1 << 28)) != 0;
+
+    bool avx2 = false;
+    if (maxLeaf >= 7 && osxsave && avx) {
+        // OS saves the YMM state
+        bool ymm = (_xgetbv(0) & 0x6) == 0x6;
+        __cpuidex(r, 7, 0);
+        avx2 = ymm && (r[1] & (1 << 5)) != 0;
+    }
+#else
+    __builtin_cpu_init();
+    bool sse41 = __builtin_cpu_supports("sse4.1");
+    bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+    if (avx2) return NoiseIsa::AVX2;
+    if (sse41) return NoiseIsa::SSE41;
+    return NoiseIsa::Scalar;
+}
+
+#else
+
+static NoiseIsa DetectNoiseIsa() { return NoiseIsa::Scalar; }
+
+#endif // NOISE_X86
+
+static NoiseIsa SupportedNoiseIsa()
+{
+    static const NoiseIsa best = DetectNoiseIsa();
+    return best;
+}
+
+static std::atomic<int> g_noiseIsa{ -1 }; // -1 = not picked yet
+
+NoiseIsa GetNoiseIsa()
+{
+    int isa = g_noiseIsa.load(std::memory_order_relaxed);
+    if (isa < 0) {
+        isa = (int)SupportedNoiseIsa();
+        g_noiseIsa.store(isa, std::memory_order_relaxed);
+    }
+    return (NoiseIsa)isa;
+}
+
+void SetNoiseIsa(NoiseIsa isa)
+{
+    if ((int)isa > (int)SupportedNoiseIsa()) isa = SupportedNoiseIsa();
+    g_noiseIsa.store((int)isa, std::memory_order_relaxed);
+}
+
+const char* NoiseIsaName(NoiseIsa isa)
+{
+    switch (isa) {
+    case NoiseIsa::AVX2:  return "avx2";
+    case NoiseIsa::SSE41: return "sse4.1";
+    default:              return "scalar";
+    }
+}
+
+void FBMBatch(const glm::vec3* p, float* out, size_t n, int octaves)
+{
+    switch (GetNoiseIsa()) {
+#ifdef NOISE_X86
+    case NoiseIsa::AVX2:  FBMBatchAVX2(p, out, n, octaves); return;
+    case NoiseIsa::SSE41: FBMBatchSSE41(p, out, n, octaves); return;
+#endif
+    default:              FBMBatchScalar(p, out, n, octaves); return;
+    }
+}
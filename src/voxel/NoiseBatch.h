@@ -0,0 +1,21 @@
+#pragma once
+#include <cstddef>
+#include <glm.hpp>
+
+// Batched FBM over arrays of points. Results are bit-identical to calling
+// the scalar FBM (Noise.h) per point: the SIMD kernels do the same float
+// ops in the same order, with no FMA. That also assumes the scalar build
+// doesn't contract a*b+c into FMA (MSVC default; GCC/Clang need
+// -ffp-contract=off).
+
+enum class NoiseIsa { Scalar, SSE41, AVX2 };
+
+// out[i] = FBM(p[i], octaves). Any n; the tail that doesn't fill a vector
+// runs scalar.
+void FBMBatch(const glm::vec3* p, float* out, size_t n, int octaves);
+
+// Best kernel this CPU/OS supports; picked on first use.
+NoiseIsa GetNoiseIsa();
+// Force a kernel (benchmarks, A/B checks). Clamped to what the CPU supports.
+void SetNoiseIsa(NoiseIsa isa);
+const char* NoiseIsaName(NoiseIsa isa);
@@ -2,6 +2,7 @@
 #include <glm.hpp>
 #include "Voxel.h"
 #include "Noise.h"
+#include "HeightCache.h"
 #include <cmath>
 
 struct PlanetParams {
@@ -13,12 +14,25 @@ struct PlanetParams {
     float seaLevelOffset = -2.f;
 };
 
-inline float HeightOnSphere(glm::vec3 dir, const PlanetParams& pp) {
+// The FBM the height tiles are sampled from.
+inline float HeightOnSphereExact(glm::vec3 dir, const PlanetParams& pp) {
     // dir normalized
     float h = FBM(dir * pp.noiseFreq, pp.octaves); // [-1,1]
     return h * pp.maxHeight;
 }
 
+// Surface height above baseRadius, bilinear from the shared cube-sphere tile
+// cache (HeightCache.h). Stays within +-maxHeight like the exact one.
+inline float HeightOnSphere(glm::vec3 dir, const PlanetParams& pp) {
+    return SurfaceHeights().Height(dir, pp);
+}
+
+// Caves only start this deep, so they never break through the surface.
+static constexpr float CAVE_MIN_DEPTH = 4.0f;
+static constexpr float CAVE_FREQ = 0.06f;
+static constexpr int   CAVE_OCTAVES = 4;
+static constexpr float CAVE_THRESHOLD = 0.35f;
+
 // Inputs 
 //  p = world position(voxel center), in voxel units
 //  depth = (surfaceR - d).depth > 0 means inside planet
@@ -26,13 +40,13 @@ inline float HeightOnSphere(glm::vec3 dir, const PlanetParams& pp) {
 // Output:
 //  true -> carve to air
 inline bool ShouldCarveCave(glm::vec3 p, float depth) {
-    if (depth < 4.0f) return false;
-    float n = FBM(p * 0.06f, 4);
-    return n > 0.35f;
+    if (depth < CAVE_MIN_DEPTH) return false;
+    float n = FBM(p * CAVE_FREQ, CAVE_OCTAVES);
+    return n > CAVE_THRESHOLD;
 }
 
 inline bool ShoudCarveCave(glm::vec3 p, float depth) {
-    if (depth < 4.0f) return false;
+    if (depth < CAVE_MIN_DEPTH) return false;
     float n = FBM(p * 0.06f, 4);
     return n > 0.35f;
 }
@@ -80,14 +94,18 @@ inline Block SamplePlanet(glm::vec3 p, const PlanetParams& pp) {
 //    return false;  // Air has no faces
 //}
 
-inline Block SamplePlanetWithOcean(glm::vec3 p, const PlanetParams& pp)
+// SamplePlanetWithOcean split around its two noise lookups, so ChunkGen can
+// evaluate the noise for a whole chunk in batches (NoiseBatch.h):
+//   height = HeightOnSphere(dir)
+//   caveN  = FBM(p * CAVE_FREQ, CAVE_OCTAVES), only read if NeedsCaveNoise
+inline bool NeedsCaveNoise(float d, float height, const PlanetParams& pp)
 {
-    float d = glm::length(p);
-    if (d < 1e-5f) return Block::Stone;
-
-    glm::vec3 dir = p / d;
+    float surfaceR = pp.baseRadius + height;
+    return surfaceR - d >= CAVE_MIN_DEPTH;
+}
 
-    float height = HeightOnSphere(dir, pp);
+inline Block PlanetBlockFromNoise(glm::vec3 dir, float d, float height, float caveN, const PlanetParams& pp)
+{
     float surfaceR = pp.baseRadius + height;
     float seaR = pp.baseRadius + pp.seaLevelOffset;
 
@@ -101,7 +119,7 @@ inline Block SamplePlanetWithOcean(glm::vec3 p, const PlanetParams& pp)
     float depth = surfaceR - d; // >0 inside
 
     // caves
-    if (ShouldCarveCave(p, depth)) return Block::Air;
+    if (depth >= CAVE_MIN_DEPTH && caveN > CAVE_THRESHOLD) return Block::Air;
 
     // top layer (beach if below/near sea)
     if (depth < 1.0f) {
@@ -120,5 +138,14 @@ inline Block SamplePlanetWithOcean(glm::vec3 p, const PlanetParams& pp)
     return Block::Stone;
 }
 
+inline Block SamplePlanetWithOcean(glm::vec3 p, const PlanetParams& pp)
+{
+    float d = glm::length(p);
+    if (d < 1e-5f) return Block::Stone;
 
+    glm::vec3 dir = p / d;
 
+    float height = HeightOnSphere(dir, pp);
+    float caveN = NeedsCaveNoise(d, height, pp) ? FBM(p * CAVE_FREQ, CAVE_OCTAVES) : 0.0f;
+    return PlanetBlockFromNoise(dir, d, height, caveN, pp);
+}
@@ -0,0 +1,394 @@
+#include "RegionStore.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+#include "Planet.h"
+
+static_assert(RegionStore::REGION_SIZE == 16, "RegionOf / SlotIndex shift by 4");
+
+namespace {
+
+constexpr size_t SUMMARY_BYTES = BLOCK_TYPE_COUNT * 2 + 2 + 1;
+
+// everything on disk is little-endian; so is every target we build for
+void PutU16(uint8_t*& p, uint16_t v) { std::memcpy(p, &v, 2); p += 2; }
+void PutU32(uint8_t* p, uint32_t v) { std::memcpy(p, &v, 4); }
+void PutU64(uint8_t* p, uint64_t v) { std::memcpy(p, &v, 8); }
+uint16_t GetU16(const uint8_t*& p) { uint16_t v; std::memcpy(&v, p, 2); p += 2; return v; }
+uint32_t GetU32(const uint8_t* p) { uint32_t v; std::memcpy(&v, p, 4); return v; }
+uint64_t GetU64(const uint8_t* p) { uint64_t v; std::memcpy(&v, p, 8); return v; }
+
+// fseek takes a long, which is 32 bits on Windows
+int Seek(FILE* f, uint64_t offset)
+{
+#ifdef _WIN32
+    return _fseeki64(f, (long long)offset, SEEK_SET);
+#else
+    return fseeko(f, (off_t)offset, SEEK_SET);
+#endif
+}
+
+// FNV-1a over the params that shape terrain, so a file written for other
+// params (or an older format) is never read back
+uint64_t HashPlanet(const PlanetParams& pp, uint32_t version)
+{
+    uint64_t h = 1469598103934665603ull;
+    auto mix = [&](const void* data, size_t n) {
+        const uint8_t* b = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < n; i++) { h ^= b[i]; h *= 1099511628211ull; }
+    };
+    mix(&version, sizeof(version));
+    mix(&pp.baseRadius, sizeof(pp.baseRadius));
+    mix(&pp.maxHeight, sizeof(pp.maxHeight));
+    mix(&pp.noiseFreq, sizeof(pp.noiseFreq));
+    mix(&pp.octaves, sizeof(pp.octaves));
+    mix(&pp.seaLevelOffset, sizeof(pp.seaLevelOffset));
+    return h;
+}
+
+} // namespace
+
+RegionStore::RegionStore(const std::string& dir, const PlanetParams& pp)
+    : dir_(dir), planetKey_(HashPlanet(pp, VERSION))
+{
+    std::error_code ec;
+    std::filesystem::create_directories(dir_, ec);
+    io_ = std::thread([this] { IoMain(); });
+}
+
+RegionStore::~RegionStore()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    work_.notify_all();
+    io_.join();
+}
+
+ChunkCoord RegionStore::RegionOf(ChunkCoord cc)
+{
+    // arithmetic shift: floor division for negatives too
+    return { cc.x >> 4, cc.y >> 4, cc.z >> 4 };
+}
+
+int RegionStore::SlotIndex(ChunkCoord cc)
+{
+    return (cc.x & 15) + REGION_SIZE * ((cc.y & 15) + REGION_SIZE * (cc.z & 15));
+}
+
+uint64_t RegionStore::Key(ChunkCoord cc)
+{
+    // same packing as ChunkDirectory: 21 bits per axis
+    auto field = [](int v) { return (uint64_t)((uint32_t)(v + (1 << 20)) & 0x1FFFFFu); };
+    return field(cc.x) | (field(cc.y) << 21) | (field(cc.z) << 42);
+}
+
+std::string RegionStore::PathOf(ChunkCoord rc) const
+{
+    char name[64];
+    std::snprintf(name, sizeof(name), "r.%d.%d.%d.vreg", rc.x, rc.y, rc.z);
+    return (std::filesystem::path(dir_) / name).string();
+}
+
+RegionStore::Region& RegionStore::RegionLocked(ChunkCoord rc)
+{
+    std::unique_ptr<Region>& slot = regions_[Key(rc)];
+    if (slot) return *slot;
+
+    slot = std::make_unique<Region>();
+    Region& r = *slot;
+    r.rc = rc;
+    r.table.assign(REGION_CHUNKS, Slot{});
+
+    std::shared_ptr<MappedFile> map = MappedFile::Open(PathOf(rc));
+    if (!map || map->Size() < HEADER_BYTES + TABLE_BYTES) return r;
+
+    const uint8_t* h = map->Data();
+    if (std::memcmp(h, "VREG", 4) != 0 || GetU32(h + 4) != VERSION ||
+        GetU64(h + 8) != planetKey_ || GetU32(h + 16) != (uint32_t)REGION_SIZE)
+        return r; // someone else's; the next write replaces it
+
+    const uint8_t* t = h + HEADER_BYTES;
+    for (int i = 0; i < REGION_CHUNKS; i++) {
+        Slot s{ GetU32(t + i * 8), GetU32(t + i * 8 + 4) };
+        if ((uint64_t)s.offset + s.size <= map->Size()) {
+            r.table[i] = s;
+            r.liveBytes += s.size;
+        }
+    }
+    r.onDisk = true;
+    r.fileSize = map->Size();
+    r.map = std::move(map);
+    return r;
+}
+
+bool RegionStore::Decode(const uint8_t* p, size_t n, BlockStorage& blocks, ChunkSummary& summary)
+{
+    if (n < SUMMARY_BYTES) return false;
+
+    ChunkSummary s;
+    uint32_t total = 0;
+    for (int t = 0; t < BLOCK_TYPE_COUNT; t++) total += s.counts[t] = GetU16(p);
+    s.opaque = GetU16(p);
+    s.opaqueFaces = *p++;
+    if (total != (uint32_t)CHUNK_VOLUME || s.opaque > CHUNK_VOLUME) return false;
+
+    if (!blocks.Read(p, n - SUMMARY_BYTES)) return false;
+    summary = s;
+    return true;
+}
+
+bool RegionStore::Load(ChunkCoord cc, BlockStorage& blocks, ChunkSummary& summary)
+{
+    Payload pending;
+    std::shared_ptr<MappedFile> map;
+    Slot s;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto p = pending_.find(Key(cc));
+        if (p != pending_.end()) {
+            pending = p->second.payload;
+        } else {
+            Region& r = RegionLocked(RegionOf(cc));
+            s = r.table[SlotIndex(cc)];
+            if (s.offset && (!r.map || r.map->Size() < (uint64_t)s.offset + s.size))
+                r.map = MappedFile::Open(PathOf(r.rc)); // grew since mapped
+            if (!s.offset || !r.map || r.map->Size() < (uint64_t)s.offset + s.size) {
+                stats_.misses++;
+                return false;
+            }
+            map = r.map;
+        }
+    }
+
+    // decode outside the lock; the mapping stays alive through map
+    bool ok = pending ? Decode(pending->data(), pending->size(), blocks, summary)
+        : Decode(map->Data() + s.offset, s.size, blocks, summary);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (ok) stats_.loads++;
+    else { stats_.corrupt++; stats_.misses++; }
+    return ok;
+}
+
+uint64_t RegionStore::Save(ChunkCoord cc, const BlockStorage& blocks, const ChunkSummary& summary)
+{
+    auto bytes = std::make_shared<std::vector<uint8_t>>(SUMMARY_BYTES);
+    uint8_t* p = bytes->data();
+    for (int t = 0; t < BLOCK_TYPE_COUNT; t++) PutU16(p, summary.counts[t]);
+    PutU16(p, summary.opaque);
+    *p++ = summary.opaqueFaces;
+    blocks.Write(*bytes);
+
+    uint64_t ticket;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ticket = ++lastTicket_;
+        pending_[Key(cc)].payload = bytes;
+        queue_.push_back({ cc, std::move(bytes), ticket });
+    }
+    work_.notify_one();
+    return ticket;
+}
+
+bool RegionStore::Written(ChunkCoord cc, uint64_t ticket) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto p = pending_.find(Key(cc));
+    return p == pending_.end() || p->second.written >= ticket;
+}
+
+std::vector<uint8_t> RegionStore::EmptyRegionHead() const
+{
+    std::vector<uint8_t> head(HEADER_BYTES + TABLE_BYTES, 0);
+    std::memcpy(head.data(), "VREG", 4);
+    PutU32(head.data() + 4, VERSION);
+    PutU64(head.data() + 8, planetKey_);
+    PutU32(head.data() + 16, (uint32_t)REGION_SIZE);
+    return head;
+}
+
+// I/O thread, no lock held. A fresh region (no file, or not ours) starts
+// over with a header and an empty table.
+bool RegionStore::WritePayload(FILE*& file, Region& r, int slot, const std::vector<uint8_t>& bytes)
+{
+    std::string path = PathOf(r.rc);
+    bool fresh = !r.onDisk;
+    if (!file) {
+        file = std::fopen(path.c_str(), fresh ? "w+b" : "r+b");
+        if (!file) return false;
+    }
+
+    if (fresh) {
+        std::vector<uint8_t> head = EmptyRegionHead();
+        if (Seek(file, 0) != 0 || std::fwrite(head.data(), 1, head.size(), file) != head.size())
+            return false;
+    }
+
+    uint64_t offset = fresh ? HEADER_BYTES + TABLE_BYTES : r.fileSize;
+    if (offset + bytes.size() > 0xFFFFFFFFull) return false; // table offsets are u32
+
+    // payload first, then the table entry that points at it
+    uint8_t entry[8];
+    PutU32(entry, (uint32_t)offset);
+    PutU32(entry + 4, (uint32_t)bytes.size());
+    if (Seek(file, offset) != 0 ||
+        std::fwrite(bytes.data(), 1, bytes.size(), file) != bytes.size() ||
+        Seek(file, HEADER_BYTES + (uint64_t)slot * 8) != 0 ||
+        std::fwrite(entry, 1, sizeof(entry), file) != sizeof(entry))
+        return false;
+
+    // readers map the file separately; they have to see the bytes before
+    // the in-memory table points at them
+    return std::fflush(file) == 0;
+}
+
+// I/O thread, no lock held; r's table only changes on this thread.
+bool RegionStore::WriteCompacted(const Region& r, const std::string& path,
+    std::vector<Slot>& table, uint64_t& size) const
+{
+    std::unique_ptr<MappedFile> old = MappedFile::Open(PathOf(r.rc));
+    if (!old || old->Size() < r.fileSize) return false;
+
+    std::vector<uint8_t> out = EmptyRegionHead();
+    out.reserve(HEADER_BYTES + TABLE_BYTES + r.liveBytes);
+    table.assign(REGION_CHUNKS, Slot{});
+    for (int i = 0; i < REGION_CHUNKS; i++) {
+        Slot s = r.table[i];
+        if (!s.offset) continue;
+        table[i] = { (uint32_t)out.size(), s.size };
+        PutU32(out.data() + HEADER_BYTES + (size_t)i * 8, table[i].offset);
+        PutU32(out.data() + HEADER_BYTES + (size_t)i * 8 + 4, s.size);
+        out.insert(out.end(), old->Data() + s.offset, old->Data() + s.offset + s.size);
+    }
+    old.reset(); // unmapped before the rename replaces the file
+    size = out.size();
+
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) return false;
+    bool ok = std::fwrite(out.data(), 1, out.size(), f) == out.size();
+    return std::fclose(f) == 0 && ok;
+}
+
+void RegionStore::IoMain()
+{
+    std::unordered_map<uint64_t, FILE*> files; // by region, open while busy
+    bool reported = false;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        work_.wait(lock, [&] { return stop_ || !queue_.empty(); });
+        if (queue_.empty()) break; // stopping, and everything's written
+
+        Write w = std::move(queue_.front());
+        queue_.pop_front();
+
+        uint64_t key = Key(w.cc);
+        auto p = pending_.find(key);
+        bool current = p != pending_.end() && p->second.payload == w.payload;
+        if (current) {
+            writing_ = true;
+            ChunkCoord rc = RegionOf(w.cc);
+            Region& r = RegionLocked(rc);
+            FILE*& file = files[Key(rc)];
+
+            lock.unlock();
+            bool wasFresh = !r.onDisk; // only this thread changes onDisk
+            uint64_t offset = wasFresh ? HEADER_BYTES + TABLE_BYTES : r.fileSize;
+            bool ok = WritePayload(file, r, SlotIndex(w.cc), *w.payload);
+            lock.lock();
+
+            if (ok) {
+                if (wasFresh) {
+                    std::fill(r.table.begin(), r.table.end(), Slot{});
+                    r.map.reset();
+                    r.onDisk = true;
+                    r.liveBytes = 0;
+                }
+                Slot& s = r.table[SlotIndex(w.cc)];
+                r.liveBytes = r.liveBytes - s.size + w.payload->size();
+                s = { (uint32_t)offset, (uint32_t)w.payload->size() };
+                r.fileSize = offset + w.payload->size();
+                stats_.writes++;
+                stats_.bytesWritten += w.payload->size();
+            } else if (!reported) {
+                std::cerr << "[RegionStore] write failed: " << PathOf(rc) << "\n";
+                reported = true;
+            }
+
+            // superseded payloads outweigh live ones: rewrite without them
+            uint64_t dead = r.fileSize - (HEADER_BYTES + TABLE_BYTES) - r.liveBytes;
+            if (ok && dead > r.liveBytes + COMPACT_SLACK) {
+                lock.unlock();
+                if (file) { std::fclose(file); file = nullptr; }
+                std::string path = PathOf(rc), tmp = path + ".tmp";
+                std::vector<Slot> table;
+                uint64_t size = 0;
+                bool packed = WriteCompacted(r, tmp, table, size);
+                lock.lock();
+
+                // under the lock, so no reader pairs a slot with the wrong
+                // file; readers mid-decode keep the old mapping alive
+                std::error_code ec;
+                if (packed) {
+                    r.map.reset();
+                    std::filesystem::rename(tmp, path, ec);
+                }
+                if (packed && !ec) {
+                    r.table = std::move(table);
+                    r.fileSize = size;
+                    stats_.compactions++;
+                } else {
+                    std::filesystem::remove(tmp, ec);
+                    if (!reported) {
+                        std::cerr << "[RegionStore] compaction failed: " << path << "\n";
+                        reported = true;
+                    }
+                }
+            }
+
+            // a newer Save may have replaced it while we were writing
+            p = pending_.find(key);
+            if (p != pending_.end()) {
+                if (p->second.payload == w.payload) pending_.erase(p);
+                else if (ok) p->second.written = w.ticket;
+            }
+            writing_ = false;
+        }
+
+        if (queue_.empty()) {
+            for (auto& f : files) if (f.second) std::fclose(f.second);
+            files.clear();
+            idle_.notify_all();
+        }
+    }
+
+    for (auto& f : files) if (f.second) std::fclose(f.second);
+    idle_.notify_all();
+}
+
+void RegionStore::Flush()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [&] { return queue_.empty() && !writing_; });
+}
+
+size_t RegionStore::Pending() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_.size();
+}
+
+RegionStore::Stats RegionStore::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats s = stats_;
+    s.pending = pending_.size();
+    s.regions = regions_.size();
+    return s;
+}
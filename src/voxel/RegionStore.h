@@ -0,0 +1,132 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Chunk.h"
+#include "MappedFile.h"
+
+struct PlanetParams;
+
+// Chunks on disk, REGION_SIZE^3 to a region file:
+//
+//   header   "VREG", version, planet key, REGION_SIZE   (HEADER_BYTES)
+//   table    REGION_CHUNKS x { u32 offset, u32 size }, offset 0 = absent
+//   payloads ChunkSummary fields + BlockStorage::Write bytes, appended
+//
+// Reads map the file (MappedFile) and decode straight out of the view; they
+// are safe from any thread, so gen workers load from here before falling
+// back to generation. Writes are queued by Save and done by one I/O thread,
+// so the caller only pays for encoding. Payloads are append-only: a rewrite
+// goes to the end and repoints the table entry, so a reader decoding the
+// old bytes never sees them change. Once a region's dead bytes outnumber its
+// live ones, the I/O thread copies the live payloads into a new file and
+// renames it over the old; readers still decoding hold the old mapping.
+//
+// A file whose header doesn't match the planet key is ignored and replaced
+// on the next write, so changing PlanetParams doesn't load stale terrain.
+class RegionStore {
+public:
+    static constexpr int REGION_SIZE = 16; // chunks per axis per file
+    static constexpr int REGION_CHUNKS = REGION_SIZE * REGION_SIZE * REGION_SIZE;
+
+    struct Stats {
+        uint64_t loads = 0;        // Load hits (file or pending write)
+        uint64_t misses = 0;       // Load found nothing
+        uint64_t corrupt = 0;      // payloads that failed to decode (treated as misses)
+        uint64_t writes = 0;       // payloads written by the I/O thread
+        uint64_t bytesWritten = 0;
+        uint64_t compactions = 0;  // region files rewritten without dead payloads
+        size_t pending = 0;        // saved, not written yet
+        size_t regions = 0;        // region tables in memory
+    };
+
+    // dir is created if missing. Starts the I/O thread.
+    RegionStore(const std::string& dir, const PlanetParams& pp);
+    // Writes everything still queued, then stops the I/O thread.
+    ~RegionStore();
+
+    RegionStore(const RegionStore&) = delete;
+    RegionStore& operator=(const RegionStore&) = delete;
+
+    // Any thread. The newest Save of cc if it hasn't been written yet,
+    // else what its region file has.
+    bool Load(ChunkCoord cc, BlockStorage& blocks, ChunkSummary& summary);
+
+    // Encodes now and queues the write; a later Save of the same cc before
+    // it's written supersedes it. Returns a ticket for Written.
+    uint64_t Save(ChunkCoord cc, const BlockStorage& blocks, const ChunkSummary& summary);
+    // The Save of cc that returned ticket, or a later one, is in the file.
+    bool Written(ChunkCoord cc, uint64_t ticket) const;
+
+    // Blocks until the I/O thread has written everything queued so far.
+    void Flush();
+
+    size_t Pending() const;
+    Stats GetStats() const;
+    const std::string& Dir() const { return dir_; }
+    // hash of the format version and terrain params; files carry it
+    uint64_t PlanetKey() const { return planetKey_; }
+
+private:
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t HEADER_BYTES = 24;
+    static constexpr size_t TABLE_BYTES = (size_t)REGION_CHUNKS * 8;
+    // dead bytes a region may carry beyond its live ones before compacting
+    static constexpr uint64_t COMPACT_SLACK = 256u << 10;
+
+    using Payload = std::shared_ptr<const std::vector<uint8_t>>;
+
+    struct Slot { uint32_t offset = 0; uint32_t size = 0; };
+
+    struct Region {
+        ChunkCoord rc{};
+        bool onDisk = false;             // file exists with our header
+        std::vector<Slot> table;         // REGION_CHUNKS, mirrors the file
+        uint64_t fileSize = 0;
+        uint64_t liveBytes = 0;          // payloads the table points at
+        std::shared_ptr<MappedFile> map; // reopened when it doesn't cover a slot
+    };
+
+    struct Write { ChunkCoord cc; Payload payload; uint64_t ticket; };
+
+    // newest Save of a chunk not written yet; ticket of the newest that was
+    struct PendingSave { Payload payload; uint64_t written = 0; };
+
+    static ChunkCoord RegionOf(ChunkCoord cc);
+    static int SlotIndex(ChunkCoord cc);
+    static uint64_t Key(ChunkCoord cc);
+    std::string PathOf(ChunkCoord rc) const;
+
+    static bool Decode(const uint8_t* p, size_t n, BlockStorage& blocks, ChunkSummary& summary);
+
+    Region& RegionLocked(ChunkCoord rc);
+    std::vector<uint8_t> EmptyRegionHead() const; // header + all-absent table
+    bool WritePayload(FILE*& file, Region& r, int slot, const std::vector<uint8_t>& bytes);
+    // live payloads of r packed into path; table/size describe the result
+    bool WriteCompacted(const Region& r, const std::string& path, std::vector<Slot>& table, uint64_t& size) const;
+    void IoMain();
+
+    std::string dir_;
+    uint64_t planetKey_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable work_;  // queue non-empty or stopping
+    std::condition_variable idle_;  // queue drained
+    std::unordered_map<uint64_t, std::unique_ptr<Region>> regions_; // by region coord
+    std::unordered_map<uint64_t, PendingSave> pending_;               // by chunk coord
+    uint64_t lastTicket_ = 0;
+    std::deque<Write> queue_;
+    bool writing_ = false;
+    bool stop_ = false;
+    Stats stats_;
+
+    std::thread io_;
+};
@@ -1,7 +1,5 @@
 #include "World.h"
 #include "Mesher.h"
-#include <glad/glad.h>
-#include <GLFW/glfw3.h>
 #include <glm.hpp>
 #include <algorithm>
 #include <iostream>
@@ -28,7 +26,7 @@ void World::BuildPlanetOnce() {
 }
 
 void World::RebuildDirtyMeshes() {
-    for (auto& [cc, c] : chunks) {
+    chunkPool.ForEach([&](Chunk& c) {
         if (c.dirty) BuildChunkMesh(c);
-    }
+    });
 }
\ No newline at end of file
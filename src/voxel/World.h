@@ -1,28 +1,26 @@
 #pragma once
 
 
-#include <unordered_map>
 #include <vector>
 #include <deque>
+#include <memory>
 #include <glm.hpp>
 #include "Chunk.h"
 #include "Planet.h"
+#include "MeshSink.h"
+#include "Frustum.h"
+#include "ChunkGen.h"
+#include "ChunkQueue.h"
+#include "ChunkPool.h"
+#include "ChunkDirectory.h"
+#include "BuildScheduler.h"
+#include "ColdChunkCache.h"
+#include "RegionStore.h"
+#include "EditJournal.h"
+#include "../mesh/ChunkMeshJob.h"
 #include <algorithm>
 #include <cstdlib>
 
-struct ChunkCoordHash {
-    size_t operator()(const ChunkCoord& c) const noexcept {
-        size_t h1 = std::hash<int>{}(c.x);
-        size_t h2 = std::hash<int>{}(c.y);
-        size_t h3 = std::hash<int>{}(c.z);
-        return h1 ^ (h2 * 0x9e3779b97f4a7c15ull) ^ (h3 * 0x85ebca6bull);
-    }
-};
-
-inline bool operator==(const ChunkCoord& a, const ChunkCoord& b) {
-    return a.x == b.x && a.y == b.y && a.z == b.z;
-}
-
 // handles negatives correctly
 inline int FloorDiv(int a, int b) {
     int q = a / b;
@@ -65,6 +63,7 @@ static const glm::ivec2 SIDE_TILE[6] = {
 
 
 class World {
+    friend class BlockCursor;
 public:
     PlanetParams planet;
     struct StreamStats
@@ -72,11 +71,104 @@ public:
         size_t loaded = 0;
         size_t generated = 0;
         size_t meshed = 0;
-        size_t target = 0;
+        size_t target = 0;        // render-cube chunks that aren't ChunkShell::Sky
         size_t genQ = 0;
         size_t meshQ = 0;
+        size_t genInFlight = 0;   // submitted to gen workers, not integrated yet
+        size_t meshInFlight = 0;  // submitted to mesh workers, not drained yet
+        size_t uploadQ = 0;       // meshed, waiting for MeshSink::Upload
+        int genWorkers = 0;
+        int meshWorkers = 0;
         int renderDistance = 0;
         int unloadDistance = 0;
+
+        // last DrawOpaque / DrawWater(Sorted): chunks submitted vs rejected
+        // by the frustum (both only count chunks with geometry in range)
+        size_t drawnOpaque = 0;
+        size_t culledOpaque = 0;
+        size_t drawnWater = 0;
+        size_t culledWater = 0;
+
+        // Chunk::blocks across loaded chunks, by BlockStorage mode
+        size_t blockBytes = 0;
+        size_t uniformChunks = 0;
+        size_t paletteChunks = 0;
+        size_t expandedChunks = 0;
+
+        // ChunkPool: slots allocated vs loaded, and loads served by reuse
+        size_t poolCapacity = 0;
+        size_t poolHighWater = 0;
+        size_t poolSlabs = 0;
+        size_t poolReused = 0;
+
+        // ChunkDirectory (coord -> handle table)
+        size_t dirCapacity = 0;
+        size_t dirTombstones = 0;
+        size_t dirRebuilds = 0;
+
+        // BuildScheduler, last TickBuildQueues: budget after frame-time
+        // scaling, main-thread time it spent, and items per stage
+        double budgetUs = 0.0;
+        double budgetSpentUs = 0.0;
+        double budgetScale = 1.0;
+        size_t budgetGen = 0;
+        size_t budgetMesh = 0;
+        size_t budgetUploads = 0;
+        double genCostUs = 0.0;    // per-item moving averages
+        double meshCostUs = 0.0;
+        double uploadCostUs = 0.0;
+
+        // ColdChunkCache: unloaded chunks' blocks kept for restoring
+        size_t coldChunks = 0;
+        size_t coldBytes = 0;
+        size_t coldBudget = 0;
+        size_t coldEvicted = 0;
+
+        // RegionStore (0s when none is open)
+        size_t saveQ = 0;          // unsaved chunks waiting for their Save
+        size_t regionPending = 0;  // saved, not written by the I/O thread yet
+        size_t regionWrites = 0;
+        size_t regionBytes = 0;
+        size_t regionLoads = 0;
+        size_t regionCompactions = 0;
+
+        // EditJournal: player edits as deltas against generation
+        size_t editChunks = 0;     // chunks with deltas or a snapshot
+        size_t editDeltas = 0;
+        size_t editSnapshots = 0;
+        size_t journalBytes = 0;   // log file, 0 when no region store is open
+    };
+
+    // Cumulative pipeline counters (since construction or ResetBuildStats).
+    // Times are wall-clock seconds spent inside each stage.
+    struct BuildStats
+    {
+        size_t generated = 0;      // chunks run through FillChunkBlocks
+        size_t meshed = 0;         // chunks run through the mesher
+        size_t unloaded = 0;
+        size_t genCancelled = 0;   // unloaded while a gen worker had it
+        size_t meshStale = 0;      // worker meshes dropped (remeshed/unloaded since)
+        size_t meshSkipped = 0;    // queued meshes dropped: ChunkSummary says no faces
+        size_t overBudget = 0;     // TickBuildQueues calls that ran past their budget
+        size_t prefetched = 0;     // requested from the look-ahead cube, outside the render cube
+        size_t prefetchHits = 0;   // entered the render cube already generated + meshed
+        size_t prefetchMisses = 0; // entered the render cube still to be built
+        size_t restored = 0;       // brought back from the cold tier instead of generated
+        size_t loadedFromDisk = 0; // read from the RegionStore instead of generated
+        size_t saved = 0;          // handed to RegionStore::Save
+        size_t edits = 0;          // SetBlock calls that changed a voxel
+        size_t editsApplied = 0;   // journal deltas written over loaded chunks
+        size_t snapshots = 0;      // edited chunks saved whole, their deltas dropped
+        size_t buried = 0;         // ChunkShell::Buried markers placed instead of gen + mesh
+        size_t ocean = 0;          // ChunkShell::Ocean markers, same
+        size_t quadsOpaque = 0;
+        size_t quadsWater = 0;
+
+        double streamSec = 0.0;    // UpdateStreaming
+        double genSec = 0.0;       // FillChunkBlocks (summed over gen workers)
+        double diskSec = 0.0;      // RegionStore loads, same
+        double meshSec = 0.0;      // BuildChunkMeshGreedy (summed over mesh workers)
+        double uploadSec = 0.0;    // MeshSink::Upload
     };
 
     int GetRenderDistance() const { return renderDistance; }
@@ -85,20 +177,78 @@ public:
     StreamStats GetStreamStats() const
     {
         StreamStats s;
-        s.loaded = chunks.size();
-        s.genQ = genQueue.size();
-        s.meshQ = meshQueue.size();
+        s.loaded = chunkPool.Size();
+        s.genQ = genQueue.Size();
+        s.meshQ = meshQueue.Size();
+        s.genInFlight = genPool ? genPool->InFlight() : 0;
+        s.meshInFlight = meshPool ? meshPool->InFlight() : 0;
+        s.uploadQ = uploadQueue.size();
+        s.genWorkers = genWorkers;
+        s.meshWorkers = meshWorkers;
         s.renderDistance = renderDistance;
         s.unloadDistance = unloadDistance;
+        s.drawnOpaque = drawCounts[(int)MeshPass::Opaque].drawn;
+        s.culledOpaque = drawCounts[(int)MeshPass::Opaque].culled;
+        s.drawnWater = drawCounts[(int)MeshPass::Water].drawn;
+        s.culledWater = drawCounts[(int)MeshPass::Water].culled;
 
-        int side = 2 * renderDistance + 1;
-        s.target = (size_t)side * (size_t)side * (size_t)side;
+        s.target = CountStreamTarget();
 
-        for (auto& [coord, c] : chunks)
+        chunkPool.ForEach([&](const Chunk& c)
         {
             if (c.generated) s.generated++;
             if (c.generated && !c.dirty) s.meshed++;
+
+            s.blockBytes += c.blocks.MemoryBytes();
+            int bits = c.blocks.BitsPerBlock();
+            if (bits == 0) s.uniformChunks++;
+            else if (bits == 8) s.expandedChunks++;
+            else s.paletteChunks++;
+        });
+
+        ChunkPool::Stats ps = chunkPool.GetStats();
+        s.poolCapacity = ps.capacity;
+        s.poolHighWater = ps.highWater;
+        s.poolSlabs = ps.slabs;
+        s.poolReused = ps.reused;
+
+        ChunkDirectory::Stats ds = chunkDir.GetStats();
+        s.dirCapacity = ds.capacity;
+        s.dirTombstones = ds.tombstones;
+        s.dirRebuilds = ds.rebuilds;
+
+        const BuildScheduler::Tick& bt = buildScheduler.LastTick();
+        s.budgetUs = bt.budgetUs;
+        s.budgetSpentUs = bt.spentUs;
+        s.budgetScale = bt.scale;
+        s.budgetGen = bt.items[BuildScheduler::Gen];
+        s.budgetMesh = bt.items[BuildScheduler::Mesh];
+        s.budgetUploads = bt.items[BuildScheduler::Upload];
+        s.genCostUs = buildScheduler.Cost(BuildScheduler::Gen);
+        s.meshCostUs = buildScheduler.Cost(BuildScheduler::Mesh);
+        s.uploadCostUs = buildScheduler.Cost(BuildScheduler::Upload);
+
+        ColdChunkCache::Stats cs = coldChunks.GetStats();
+        s.coldChunks = cs.chunks;
+        s.coldBytes = cs.bytes;
+        s.coldBudget = cs.budget;
+        s.coldEvicted = cs.evicted;
+
+        s.saveQ = saveQueue.size();
+        if (regionStore) {
+            RegionStore::Stats rs = regionStore->GetStats();
+            s.regionPending = rs.pending;
+            s.regionWrites = (size_t)rs.writes;
+            s.regionBytes = (size_t)rs.bytesWritten;
+            s.regionLoads = (size_t)rs.loads;
+            s.regionCompactions = (size_t)rs.compactions;
         }
+
+        EditJournal::Stats js = editJournal.GetStats();
+        s.editChunks = js.chunks;
+        s.editDeltas = js.edits;
+        s.editSnapshots = js.snapshots;
+        s.journalBytes = (size_t)js.fileBytes;
         return s;
     }
 
@@ -112,20 +262,54 @@ public:
                 for (int dx = -renderDistance; dx <= renderDistance; ++dx)
                 {
                     ChunkCoord want{ cc.x + dx, cc.y + dy, cc.z + dz };
-                    auto it = chunks.find(want);
-                    if (it == chunks.end()) return false;
-
-                    const Chunk& c = it->second;
-                    if (!c.generated) return false;
-                    if (c.dirty) return false;
+                    const Chunk* c = FindChunk(want);
+                    if (!c) {
+                        // after a streaming pass, a hole in the render cube
+                        // is a chunk RequestChunk classified as Sky
+                        if (streamResync) return false;
+                        continue;
+                    }
+
+                    if (!c->generated) return false;
+                    if (c->dirty) return false;
                 }
         return true;
     }
  
 
 
+    const BuildStats& GetBuildStats() const { return buildStats; }
+    void ResetBuildStats() { buildStats = {}; }
+
+    // Swaps where meshes go (GPU, CPU, nowhere). Releases everything held by
+    // the previous sink and marks loaded chunks for remeshing.
+    void SetMeshSink(std::unique_ptr<MeshSink> sink);
+    MeshSink& GetMeshSink() const { return *meshSink; }
+
+    // 0 = generate on the calling thread, within the TickBuildQueues budget.
+    // Otherwise TickBuildQueues keeps the pool fed and only integrates results.
+    void SetGenWorkers(int n);
+    int GetGenWorkers() const { return genWorkers; }
+
+    // 0 = mesh on the calling thread, within the TickBuildQueues budget.
+    // Otherwise meshing runs on workers and the budget only covers uploads.
+    void SetMeshWorkers(int n);
+    int GetMeshWorkers() const { return meshWorkers; }
+
+    // Which ChunkMesher backend builds chunk meshes. Remeshes loaded chunks.
+    void SetMesher(MesherKind kind);
+    MesherKind GetMesher() const { return mesher; }
+
+    // once-per-second "[Streaming]" line from TickBuildQueues
+    void SetStreamLogging(bool on) { streamLogging = on; }
+
     Chunk& GetOrCreateChunk(ChunkCoord cc);
     Block GetBlock(int wx, int wy, int wz) const;
+    // Player edit. Recorded in the edit journal as a delta against
+    // generation; remeshes the chunk, and the neighbors when the voxel is on
+    // a shared face. False if its chunk isn't loaded and generated yet (sky
+    // chunks, never allocated by streaming, are created for it).
+    bool SetBlock(int wx, int wy, int wz, Block b);
 
     void BuildPlanetOnce();        // simple start: generate whole small planet
     void RebuildDirtyMeshes();     // mesh upload step
@@ -137,61 +321,113 @@ public:
 
     //}
 
-    inline void DrawOpaque() const {
-        for (auto& [cc, c] : chunks)
-        {
-            int ddx = cc.x - streamCamChunk.x;
-            int ddy = cc.y - streamCamChunk.y;
-            int ddz = cc.z - streamCamChunk.z;
-            int distCheby = std::max({ std::abs(ddx), std::abs(ddy), std::abs(ddz) });
-
-            if (distCheby <= renderDistance)
-                c.opaque.Draw();
-        }
-        glBindVertexArray(0);
-    }
-
-
+    // Chunks within renderDistance that have geometry for the pass and
+    // touch the view frustum (if one was set this frame).
+    inline void DrawOpaque() const { DrawPass(MeshPass::Opaque); }
+    inline void DrawWater() const { DrawPass(MeshPass::Water); }
 
-     //inline void DrawWater() const {
-     //    for (auto& [cc, c] : chunks) c.water.Draw();
-     //    glBindVertexArray(0);
-     //}
-
-    inline void DrawWater() const {
-        for (auto& [cc, c] : chunks)
-        {
-            int ddx = cc.x - streamCamChunk.x;
-            int ddy = cc.y - streamCamChunk.y;
-            int ddz = cc.z - streamCamChunk.z;
-            int distCheby = std::max({ std::abs(ddx), std::abs(ddy), std::abs(ddz) });
-
-            if (distCheby <= renderDistance)
-                c.water.Draw();
-        }
-        glBindVertexArray(0);
+    // projection * view, world space. Until set, nothing is frustum-culled.
+    void SetViewFrustum(const glm::mat4& viewProj)
+    {
+        viewFrustum = Frustum::FromMatrix(viewProj);
+        hasViewFrustum = true;
     }
 
-    void UpdateStreaming(glm::vec3 cameraPos, glm::vec3 cameraForward);
-    void TickBuildQueues(int maxGenPerFrame, int maxMeshPerFrame);
+    // cameraVelocity (voxels/s) drives the look-ahead: chunks around where
+    // it takes the camera within the prefetch horizon are requested early
+    // and queued ahead of the rest.
+    void UpdateStreaming(glm::vec3 cameraPos, glm::vec3 cameraForward,
+        glm::vec3 cameraVelocity = glm::vec3(0.0f));
+    // Spends about budgetUs of this thread's time on inline generation,
+    // meshing and uploads, sized from each stage's measured per-item cost.
+    // lastFrameUs is the previous frame's length (0 = unknown); frames over
+    // SetTargetFrameTime shrink the budget until they come back under.
+    void TickBuildQueues(double budgetUs, double lastFrameUs = 0.0);
+    void SetTargetFrameTime(double us) { buildScheduler.SetTargetFrame(us); }
     void DrawWaterSorted(const glm::vec3& cameraPos);
 
-    void SetRenderDistance(int d) { renderDistance = d; }
+    void SetRenderDistance(int d) { renderDistance = d; streamResync = true; }
     void SetLoadDistance(int d) { loadDistance = d; }
-    void SetUnloadDistance(int d) { unloadDistance = d; }
+    void SetUnloadDistance(int d) { unloadDistance = d; streamResync = true; }
 
     int GetLoadDistance()   const { return loadDistance; }
 
+    // Bytes of unloaded chunks kept in the cold tier; 0 = regenerate
+    // everything that comes back into range.
+    void SetColdBudget(size_t bytes) { coldChunks.SetBudget(bytes); }
+    size_t GetColdBudget() const { return coldChunks.GetBudget(); }
+
+    // Persist the world under dir: edits go to an edit journal there, and
+    // region files hold whole chunks (snapshots of heavily edited ones, plus
+    // generated ones with SetSaveGenerated). Requested chunks are read from
+    // the region files before generating, and have their edits applied
+    // after. Open before streaming starts; params must be final, files for
+    // other params are ignored.
+    void OpenRegionStore(const std::string& dir);
+    // Saves every unsaved loaded chunk, writes the journal and waits for the
+    // writes to land.
+    void FlushRegionStore();
+    bool HasRegionStore() const { return regionStore != nullptr; }
+    // Also save generated chunks to the region files (a few per tick,
+    // within the build budget, and on unload), so revisits load instead of
+    // generating. Off by default: disk use then grows with the area
+    // explored rather than with the edits made.
+    void SetSaveGenerated(bool on) { saveGenerated = on; }
+
+    // seconds of straight-line motion to look ahead; 0 turns prefetch off
+    void SetPrefetchHorizon(float sec) { prefetchHorizon = std::max(0.0f, sec); }
+    float GetPrefetchHorizon() const { return prefetchHorizon; }
+
 
     // Streaming parameters (handy for fog / UI / debug)
     
     
 
 private:
-    std::unordered_map<ChunkCoord, Chunk, ChunkCoordHash> chunks;
-
-    std::deque<ChunkCoord> genQueue;
-    std::deque<ChunkCoord> meshQueue;
+    // Loaded chunks: storage in the pool, coord -> handle in the directory.
+    ChunkPool chunkPool;
+    ChunkDirectory chunkDir;
+    ColdChunkCache coldChunks; // unloaded, generated chunks: blocks only
+
+    Chunk* FindChunk(ChunkCoord cc);
+    const Chunk* FindChunk(ChunkCoord cc) const;
+
+    // across FACES[fi] through Chunk::neighbors, no directory lookup
+    Chunk* Neighbor(const Chunk& c, int fi) { return chunkPool.Get(c.neighbors[fi]); }
+    const Chunk* Neighbor(const Chunk& c, int fi) const { return chunkPool.Get(c.neighbors[fi]); }
+    ChunkHandle FindHandle(ChunkCoord cc) const;
+    Chunk& AddChunk(ChunkCoord cc); // cc must not be loaded
+    void RemoveChunk(ChunkCoord cc); // storage + directory only, see UnloadChunk
+
+    ChunkQueue genQueue;
+    ChunkQueue meshQueue;
+
+    std::unique_ptr<MeshSink> meshSink = std::make_unique<NullMeshSink>();
+
+    // before regionStore: its snapshot records refer to region writes, so
+    // the last of them is flushed after the region store has finished
+    EditJournal editJournal;
+    // before genPool: gen jobs point at it, so it has to outlive them
+    std::unique_ptr<RegionStore> regionStore;
+    bool saveGenerated = false;
+    std::deque<ChunkCoord> saveQueue; // chunks that went unsaved, oldest first
+    static constexpr size_t MAX_PENDING_SAVES = 512; // I/O thread backlog before saves wait
+
+    int genWorkers = ChunkGenPool::DefaultWorkerCount();
+    int genInFlightPerWorker = 8; // how far ahead of the workers we submit
+    std::unique_ptr<ChunkGenPool> genPool; // created on first tick
+    std::vector<std::unique_ptr<ChunkGenPool::Result>> genDone;
+
+    int meshWorkers = DefaultWorkerCount();
+    int meshInFlightPerWorker = 4;
+    std::unique_ptr<ChunkMeshPool> meshPool; // created on first tick
+    std::vector<std::unique_ptr<ChunkMeshPool::Result>> meshDone;
+    std::deque<std::unique_ptr<ChunkMeshPool::Result>> uploadQueue;
+    uint32_t meshVersionCounter = 0;
+    MesherKind mesher = MesherKind::Greedy;
+    BuildStats buildStats;
+    BuildScheduler buildScheduler;
+    bool streamLogging = true;
 
     int renderDistance = 5;
     int loadDistance = renderDistance; // streaming/build distance
@@ -200,13 +436,51 @@ private:
 
 
     ChunkCoord streamCamChunk{ 0,0,0 };
+    bool       streamResync = true;        // next UpdateStreaming does a full pass
     glm::vec3  streamCamForward{ 0,0,-1 }; // normalized
     float      streamFrontBias = 12.0f;     // bigger = more “front-first”
+    ChunkCoord streamAheadChunk{ 0,0,0 };   // look-ahead chunk of the last UpdateStreaming
+    float      prefetchHorizon = 1.5f;      // seconds
+
+    // CountStreamTarget result; classification is pure, so it only changes
+    // with the camera chunk or the render distance
+    struct StreamTarget { ChunkCoord at{ 0,0,0 }; int rd = -1; size_t count = 0; };
+    mutable StreamTarget streamTarget;
+
+    Frustum viewFrustum;
+    bool hasViewFrustum = false;
+
+    struct DrawCounts { size_t drawn = 0; size_t culled = 0; };
+    mutable DrawCounts drawCounts[2]; // by MeshPass, last draw of that pass
+    uint32_t drawFrame = 0; // bumped by UpdateStreaming; stamps Chunk::lastVisible
 
+    int MeshCount(const Chunk& c, MeshPass pass) const
+    {
+        return pass == MeshPass::Opaque ? c.mesh.opaqueCount : c.mesh.waterCount;
+    }
+    bool InRenderDistance(ChunkCoord cc) const;
+    bool InViewFrustum(ChunkCoord cc) const;
+    void DrawPass(MeshPass pass) const;
+
+    size_t CountStreamTarget() const;
+    Chunk* RequestChunk(ChunkCoord want);
+    void UnloadChunk(Chunk& c);
     void FillChunkBlocks(Chunk& c);
     void BuildChunkMesh(Chunk& c);
-
-    int cubeNetW = 128;
-    int cubeNetH = 96;
+    void UploadChunkMesh(Chunk& c, ChunkMeshData& mesh);
+    void QueueMesh(ChunkCoord cc, Chunk& c);
+    void QueueMeshAfterGen(ChunkCoord cc, Chunk& c);
+    bool CanHaveFaces(const Chunk& c) const;
+    bool SkipFacelessMesh(Chunk& c);
+    void TickGenPool();
+    void TickMeshPool();
+    void TickSaves();
+    void MarkUnsaved(Chunk& c);
+    void ApplyEdits(Chunk& c);
+    void FlushEditJournal();
+    void RestartGenPool();
+    std::unique_ptr<MeshSnapshot> MakeMeshSnapshot(const Chunk& c) const;
+
+    static double Now(); // steady clock, seconds
 };
 
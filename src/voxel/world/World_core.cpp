@@ -1,13 +1,169 @@
 #include "../World.h"
+#include "../Mesher.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
 
-Chunk& World::GetOrCreateChunk(ChunkCoord cc) {
-    auto it = chunks.find(cc);
-    if (it != chunks.end()) return it->second;
+double World::Now() {
+    using clock = std::chrono::steady_clock;
+    return std::chrono::duration<double>(clock::now().time_since_epoch()).count();
+}
+
+void World::SetMeshSink(std::unique_ptr<MeshSink> sink) {
+    if (!sink) sink = std::make_unique<NullMeshSink>();
+
+    chunkPool.ForEach([&](Chunk& c) {
+        meshSink->Release(c.mesh);
+        if (c.generated && !c.marker) {
+            c.dirty = true;
+            QueueMesh(c.coord, c);
+        }
+    });
+    meshSink = std::move(sink);
+}
+
+void World::SetGenWorkers(int n) {
+    n = std::max(0, n);
+    if (n == genWorkers) return;
+
+    RestartGenPool();
+    genWorkers = n;
+}
+
+// Finish the old pool's work; anything it had in flight goes back in the queue.
+void World::RestartGenPool() {
+    genPool.reset();
+    genDone.clear();
+    chunkPool.ForEach([&](Chunk& c) {
+        if (!c.genTicket) return;
+        c.genTicket.reset();
+        genQueue.Push(c.coord);
+    });
+}
+
+void World::OpenRegionStore(const std::string& dir) {
+    // in-flight gen jobs point at the old store
+    RestartGenPool();
+    if (regionStore) FlushRegionStore();
+    regionStore = std::make_unique<RegionStore>(dir, planet);
+    editJournal.Open((std::filesystem::path(dir) / "edits.vjrn").string(), regionStore->PlanetKey());
+
+    if (saveGenerated)
+        chunkPool.ForEach([&](Chunk& c) {
+            if (c.generated && !c.marker) MarkUnsaved(c);
+        });
+}
+
+void World::FlushRegionStore() {
+    if (!regionStore) return;
+
+    chunkPool.ForEach([&](Chunk& c) {
+        if (!c.unsaved) return;
+        regionStore->Save(c.coord, c.blocks, c.summary);
+        c.unsaved = false;
+        buildStats.saved++;
+    });
+    saveQueue.clear();
+    regionStore->Flush();
+    editJournal.Flush();
+}
 
-    Chunk c;
+// A snapshot record can't go out before the region write it stands for: a
+// crash in between would drop the chunk's deltas with nothing to replace
+// them. Plain deltas are safe over either the old or the new region copy.
+void World::FlushEditJournal() {
+    // waits on the snapshotted chunks' own writes, not the store's backlog
+    if (regionStore)
+        for (const EditJournal::BufferedSnapshot& s : editJournal.BufferedSnapshots())
+            if (!regionStore->Written(s.cc, s.ticket)) return;
+    editJournal.Flush();
+}
+
+// After generation or a region load; the cold tier keeps edited blocks as is.
+void World::ApplyEdits(Chunk& c) {
+    size_t n = editJournal.Apply(c.coord, c.blocks);
+    if (!n) return;
+
+    ChunkBlocks blocks;
+    c.blocks.Decode(blocks);
+    c.summary = Summarize(blocks);
+    buildStats.editsApplied += n;
+}
+
+void World::MarkUnsaved(Chunk& c) {
+    if (!regionStore || c.unsaved) return;
+    c.unsaved = true;
+    saveQueue.push_back(c.coord);
+}
+
+void World::SetMeshWorkers(int n) {
+    n = std::max(0, n);
+    if (n == meshWorkers) return;
+
+    // Jobs in the old pool are lost; remesh everything that could have had one.
+    meshPool.reset();
+    meshDone.clear();
+    chunkPool.ForEach([&](Chunk& c) {
+        if (c.generated) QueueMesh(c.coord, c);
+    });
+    meshWorkers = n;
+}
+
+void World::SetMesher(MesherKind kind) {
+    if (kind == mesher) return;
+    mesher = kind;
+    chunkPool.ForEach([&](Chunk& c) {
+        if (c.generated) QueueMesh(c.coord, c);
+    });
+}
+
+Chunk* World::FindChunk(ChunkCoord cc) {
+    return chunkPool.Get(chunkDir.Find(cc));
+}
+
+const Chunk* World::FindChunk(ChunkCoord cc) const {
+    return chunkPool.Get(chunkDir.Find(cc));
+}
+
+ChunkHandle World::FindHandle(ChunkCoord cc) const {
+    return chunkDir.Find(cc);
+}
+
+Chunk& World::AddChunk(ChunkCoord cc) {
+    ChunkHandle h = chunkPool.Acquire();
+    chunkDir.Insert(cc, h);
+
+    Chunk& c = *chunkPool.Get(h);
     c.coord = cc;
-    auto [insIt, ok] = chunks.emplace(cc, std::move(c));
-    return insIt->second;
+
+    // link both ways; FACES pairs opposite faces as fi, fi ^ 1
+    for (int fi = 0; fi < 6; fi++) {
+        const glm::ivec3 d = FACES[fi].dir;
+        ChunkHandle nh = chunkDir.Find({ cc.x + d.x, cc.y + d.y, cc.z + d.z });
+        Chunk* n = chunkPool.Get(nh);
+        if (!n) continue;
+        c.neighbors[fi] = nh;
+        n->neighbors[fi ^ 1] = h;
+    }
+    return c;
+}
+
+void World::RemoveChunk(ChunkCoord cc) {
+    ChunkHandle h = chunkDir.Find(cc);
+    Chunk* c = chunkPool.Get(h);
+    if (!c) return;
+
+    for (int fi = 0; fi < 6; fi++)
+        if (Chunk* n = chunkPool.Get(c->neighbors[fi]))
+            n->neighbors[fi ^ 1] = ChunkHandle{};
+
+    chunkPool.Release(h);
+    chunkDir.Erase(cc);
+}
+
+Chunk& World::GetOrCreateChunk(ChunkCoord cc) {
+    if (Chunk* c = FindChunk(cc)) return *c;
+    return AddChunk(cc);
 }
 
 Block World::GetBlock(int wx, int wy, int wz) const {
@@ -21,28 +177,85 @@ Block World::GetBlock(int wx, int wy, int wz) const {
     int ly = Mod(wy, CHUNK_SIZE);
     int lz = Mod(wz, CHUNK_SIZE);
 
-    auto it = chunks.find(cc);
-    if (it != chunks.end() && it->second.generated) {
-        return it->second.blocks[Idx(lx, ly, lz)];
+    const Chunk* c = FindChunk(cc);
+    if (c && c->generated) {
+        return c->blocks.Get(Idx(lx, ly, lz));
     }
 
     // if missing OR not generated yet -> procedural fallback
     glm::vec3 p = glm::vec3(wx, wy, wz) + glm::vec3(0.5f);
-    return SamplePlanetWithOcean(p, planet);
+    return SampleShell(ClassifyChunkShell(cc, planet), p, planet);
+
+}
+
+bool World::SetBlock(int wx, int wy, int wz, Block b) {
+    ChunkCoord cc = WorldToChunk(wx, wy, wz);
+    glm::ivec3 l(Mod(wx, CHUNK_SIZE), Mod(wy, CHUNK_SIZE), Mod(wz, CHUNK_SIZE));
+
+    ChunkShell shell = ClassifyChunkShell(cc, planet);
+    Chunk* c = FindChunk(cc);
+    if (!c && shell == ChunkShell::Sky) {
+        c = &AddChunk(cc);
+        c->blocks.Fill(Block::Air);
+        c->summary = SummarizeUniform(Block::Air);
+        c->generated = true;
+    }
+    if (!c || !c->generated) return false;
+
+    int i = Idx(l.x, l.y, l.z);
+    Block was = c->blocks.Get(i);
+    if (was == b) return true;
+
+    // what the chunk holds unedited
+    glm::vec3 p = glm::vec3(wx, wy, wz) + glm::vec3(0.5f);
+    Block base = SampleShell(shell, p, planet);
+    editJournal.Set(cc, i, b, b == base);
 
+    c->blocks.Set(i, b);
+    UpdateSummary(c->summary, c->blocks, l.x, l.y, l.z, was);
+    c->marker = false; // edited: meshed and unloaded like any generated chunk
+    c->dirty = true;
+    if (saveGenerated) MarkUnsaved(*c); // keep the region copy current
+    buildStats.edits++;
+
+    // dense enough that the whole chunk is cheaper than its deltas
+    if (regionStore && editJournal.EditCount(cc) >= EditJournal::SNAPSHOT_EDITS) {
+        uint64_t ticket = regionStore->Save(cc, c->blocks, c->summary);
+        editJournal.Snapshot(cc, ticket);
+        buildStats.snapshots++;
+    }
+
+    QueueMesh(cc, *c);
+    // a voxel on the boundary shows (or hides) faces in the neighbor's mesh
+    for (int fi = 0; fi < 6; fi++) {
+        glm::ivec3 q = l + FACES[fi].dir;
+        if (q.x >= 0 && q.x < CHUNK_SIZE && q.y >= 0 && q.y < CHUNK_SIZE && q.z >= 0 && q.z < CHUNK_SIZE)
+            continue;
+        Chunk* n = Neighbor(*c, fi);
+        if (n && n->generated) QueueMesh(n->coord, *n);
+    }
+    return true;
 }
 
 void World::FillChunkBlocks(Chunk& c) {
-    for (int z = 0; z < CHUNK_SIZE; z++)
-        for (int y = 0; y < CHUNK_SIZE; y++)
-            for (int x = 0; x < CHUNK_SIZE; x++) {
-                int wx = c.coord.x * CHUNK_SIZE + x;
-                int wy = c.coord.y * CHUNK_SIZE + y;
-                int wz = c.coord.z * CHUNK_SIZE + z;
-
-                glm::vec3 p = glm::vec3(wx, wy, wz) + glm::vec3(0.5f);
-                c.blocks[Idx(x, y, z)] = SamplePlanetWithOcean(p, planet);
-            }
+    double t0 = Now();
     c.dirty = true;
     c.generated = true;
-}
\ No newline at end of file
+
+    if (regionStore && regionStore->Load(c.coord, c.blocks, c.summary)) {
+        ApplyEdits(c);
+        buildStats.loadedFromDisk++;
+        buildStats.diskSec += Now() - t0;
+        return;
+    }
+
+    ChunkBlocks blocks;
+    GenerateChunkBlocks(c.coord, planet, blocks);
+    c.blocks.Assign(blocks);
+    c.summary = Summarize(blocks);
+    ApplyEdits(c);
+    if (saveGenerated) MarkUnsaved(c);
+
+    buildStats.generated++;
+    buildStats.genSec += Now() - t0;
+}
@@ -1,43 +1,42 @@
 #include "../World.h"
 
 #include "../Mesher.h"
-#include "../mesh/VoxelVertex.h"
 #include <algorithm>
 
 
-static void UploadMesh(GLuint& vao, GLuint& vbo,
-    const std::vector<VoxelVertex>& verts,
-    int& outCount)
+bool World::InRenderDistance(ChunkCoord cc) const
 {
-    if (verts.empty()) { outCount = 0; return; }
-
-    if (vao == 0) glGenVertexArrays(1, &vao);
-    if (vbo == 0) glGenBuffers(1, &vbo);
-
-    glBindVertexArray(vao);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER,
-        verts.size() * sizeof(VoxelVertex),
-        verts.data(),
-        GL_STATIC_DRAW);
-
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(VoxelVertex), (void*)offsetof(VoxelVertex, pos));
+    int ddx = cc.x - streamCamChunk.x;
+    int ddy = cc.y - streamCamChunk.y;
+    int ddz = cc.z - streamCamChunk.z;
+    int distCheby = std::max({ std::abs(ddx), std::abs(ddy), std::abs(ddz) });
+    return distCheby <= renderDistance;
+}
 
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(VoxelVertex), (void*)offsetof(VoxelVertex, localUV));
+bool World::InViewFrustum(ChunkCoord cc) const
+{
+    if (!hasViewFrustum) return true;
+    glm::vec3 mn = glm::vec3(cc.x, cc.y, cc.z) * float(CHUNK_SIZE);
+    return viewFrustum.IntersectsAABB(mn, mn + glm::vec3(float(CHUNK_SIZE)));
+}
 
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(VoxelVertex), (void*)offsetof(VoxelVertex, normal));
+void World::DrawPass(MeshPass pass) const
+{
+    DrawCounts& counts = drawCounts[(int)pass];
+    counts = {};
 
-    glEnableVertexAttribArray(3);
-    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(VoxelVertex), (void*)offsetof(VoxelVertex, layer));
+    meshSink->BeginPass(pass);
+    chunkPool.ForEach([&](const Chunk& c)
+    {
+        if (MeshCount(c, pass) == 0 || !InRenderDistance(c.coord)) return;
 
-    glEnableVertexAttribArray(4);
-    glVertexAttribPointer(4, 2, GL_FLOAT, GL_FALSE, sizeof(VoxelVertex), (void*)offsetof(VoxelVertex, tile));
-    glBindVertexArray(0);
+        if (!InViewFrustum(c.coord)) { counts.culled++; return; }
 
-    outCount = (int)verts.size();
+        meshSink->Draw(c.mesh, pass);
+        c.lastVisible = drawFrame;
+        counts.drawn++;
+    });
+    meshSink->EndPass();
 }
 
 void World::DrawWaterSorted(const glm::vec3& cameraPos)
@@ -45,17 +44,16 @@ void World::DrawWaterSorted(const glm::vec3& cameraPos)
     struct Item { float d2; Chunk* c; };
 
     std::vector<Item> list;
-    list.reserve(chunks.size());
+    list.reserve(chunkPool.Size());
 
-    for (auto& [coord, chunk] : chunks)
-    {
-        if (chunk.water.count == 0) continue; // or whatever "empty" check you use
+    DrawCounts& counts = drawCounts[(int)MeshPass::Water];
+    counts = {};
 
-        int ddx = coord.x - streamCamChunk.x;
-        int ddy = coord.y - streamCamChunk.y;
-        int ddz = coord.z - streamCamChunk.z;
-        int distCheby = std::max({ std::abs(ddx), std::abs(ddy), std::abs(ddz) });
-        if (distCheby > renderDistance) continue;
+    chunkPool.ForEach([&](Chunk& chunk)
+    {
+        const ChunkCoord& coord = chunk.coord;
+        if (chunk.mesh.waterCount == 0 || !InRenderDistance(coord)) return;
+        if (!InViewFrustum(coord)) { counts.culled++; return; }
 
         // chunk center in world space (assuming CHUNK_SIZE voxels)
         glm::vec3 center =
@@ -66,11 +64,16 @@ void World::DrawWaterSorted(const glm::vec3& cameraPos)
         float d2 = glm::dot(v, v);
 
         list.push_back({ d2, &chunk });
-    }
+    });
 
     std::sort(list.begin(), list.end(),
         [](const Item& a, const Item& b) { return a.d2 > b.d2; }); // back-to-front
 
-    for (auto& it : list)
-        it.c->water.Draw(); // or whatever your draw call is
+    meshSink->BeginPass(MeshPass::Water);
+    for (auto& it : list) {
+        meshSink->Draw(it.c->mesh, MeshPass::Water);
+        it.c->lastVisible = drawFrame;
+    }
+    counts.drawn = list.size();
+    meshSink->EndPass();
 }
\ No newline at end of file
@@ -1,6 +1,5 @@
 #include "../World.h"
 #include <algorithm>
-#include <GLFW/glfw3.h>
 #include <iostream>
 
 
@@ -17,143 +16,334 @@ ChunkCoord CameraChunk(glm::vec3 camPos) {
 }
 
 
-struct Candidate { ChunkCoord cc; int dist2; float score; };
+// Calls fn(cc) for every coord in box a that is not in box b (inclusive
+// bounds). Only the x/y columns of a are walked; z runs over results only.
+template<typename Fn>
+static void ForEachInBoxMinusBox(glm::ivec3 aMin, glm::ivec3 aMax,
+    glm::ivec3 bMin, glm::ivec3 bMax, Fn&& fn)
+{
+    glm::ivec3 oMin = glm::max(aMin, bMin);
+    glm::ivec3 oMax = glm::min(aMax, bMax);
+    bool overlap = oMin.x <= oMax.x && oMin.y <= oMax.y && oMin.z <= oMax.z;
+
+    for (int x = aMin.x; x <= aMax.x; x++)
+        for (int y = aMin.y; y <= aMax.y; y++)
+        {
+            bool inXY = overlap && x >= oMin.x && x <= oMax.x && y >= oMin.y && y <= oMax.y;
+            if (!inXY) {
+                for (int z = aMin.z; z <= aMax.z; z++) fn(ChunkCoord{ x, y, z });
+                continue;
+            }
+            for (int z = aMin.z; z < oMin.z; z++) fn(ChunkCoord{ x, y, z });
+            for (int z = oMax.z + 1; z <= aMax.z; z++) fn(ChunkCoord{ x, y, z });
+        }
+}
+
+static glm::ivec3 ToVec(const ChunkCoord& cc) { return glm::ivec3(cc.x, cc.y, cc.z); }
 
-static float ScoreChunkFrontFirst(const ChunkCoord& cc,
-    const ChunkCoord& camCC,
-    const glm::vec3& camFwdNorm,
-    float frontBias)
+// Wants cc loaded: queue generation, or place a marker / nothing per
+// ClassifyChunkShell. Returns the chunk, already there or just added;
+// nullptr for sky (unless edited).
+Chunk* World::RequestChunk(ChunkCoord want)
 {
-    glm::vec3 off = glm::vec3(cc.x - camCC.x, cc.y - camCC.y, cc.z - camCC.z);
+    if (Chunk* have = FindChunk(want)) return have;
+
+    // sky chunks are all air: never allocated; missing
+    // neighbors already sample as air for the mesher
+    ChunkShell shell = ClassifyChunkShell(want, planet);
+    bool edited = editJournal.Has(want);
+    if (shell == ChunkShell::Sky && !edited) return nullptr;
+
+    // unloaded earlier and still in the cold tier: same blocks, no gen
+    if (shell == ChunkShell::Crust || edited) {
+        BlockStorage blocks;
+        ChunkSummary summary;
+        if (coldChunks.Take(want, blocks, summary)) {
+            Chunk& c = AddChunk(want);
+            c.blocks = std::move(blocks);
+            c.summary = summary;
+            c.generated = true;
+            c.dirty = true;
+            buildStats.restored++;
+            QueueMeshAfterGen(want, c);
+            return &c;
+        }
+    }
+
+    Chunk& c = AddChunk(want);
 
-    float dist2 = glm::dot(off, off);
+    // Edited outside the crust: the shell's fill (or the region snapshot)
+    // with the deltas on top, meshed like a generated chunk. Generating it
+    // would differ from what was edited (a Buried chunk's sealed caves).
+    if (shell != ChunkShell::Crust && edited) {
+        if (!regionStore || !regionStore->Load(want, c.blocks, c.summary)) {
+            c.blocks.Fill(ShellFill(shell));
+            c.summary = SummarizeUniform(ShellFill(shell));
+        }
+        ApplyEdits(c);
+        c.generated = true;
+        c.dirty = true;
+        QueueMeshAfterGen(want, c);
+        return &c;
+    }
 
-    float d = 0.0f;
-    float len = glm::length(off);
-    if (len > 0.0001f)
-        d = glm::dot(off / len, camFwdNorm); // [-1..1], higher = more in front
+    if (shell == ChunkShell::Buried || shell == ChunkShell::Ocean) {
+        bool ocean = shell == ChunkShell::Ocean;
+        Block fill = ShellFill(shell);
+        c.blocks.Fill(fill);
+        c.summary = SummarizeUniform(fill);
+        c.marker = true;
+        c.generated = true;
+        c.dirty = false;
+        (ocean ? buildStats.ocean : buildStats.buried)++;
+        return &c;
+    }
 
-    // lower score = higher priority
-    return dist2 - d * frontBias;
+    // insert the empty chunk now so we dont enqueue duplicates
+    c.queuedGen = true;
+    genQueue.Push(want);
+    return &c;
 }
 
-static bool PopBestChunk(std::deque<ChunkCoord>& q,
-    const ChunkCoord& camCC,
-    const glm::vec3& camFwdNorm,
-    float frontBias,
-    ChunkCoord& out)
+void World::UnloadChunk(Chunk& c)
 {
-    if (q.empty()) return false;
-
-    auto bestIt = q.begin();
-    float bestScore = ScoreChunkFrontFirst(*bestIt, camCC, camFwdNorm, frontBias);
+    //Free GPU buffers too
+    meshSink->Release(c.mesh);
+    if (c.genTicket) {
+        c.genTicket->cancelled = true;
+        buildStats.genCancelled++;
+    }
 
-    for (auto it = std::next(q.begin()); it != q.end(); ++it)
-    {
-        float s = ScoreChunkFrontFirst(*it, camCC, camFwdNorm, frontBias);
-        if (s < bestScore)
-        {
-            bestScore = s;
-            bestIt = it;
-        }
+    if (c.unsaved) {
+        regionStore->Save(c.coord, c.blocks, c.summary);
+        buildStats.saved++;
     }
 
-    out = *bestIt;
-    q.erase(bestIt);
-    return true;
+    // markers come back from ClassifyChunkShell for free; generated
+    // chunks keep their blocks in the cold tier. Outside the crust only
+    // edited chunks: RequestChunk rebuilds the rest from their shell and
+    // never looks in the cold tier for them.
+    if (c.generated && !c.marker &&
+        (editJournal.Has(c.coord) || ClassifyChunkShell(c.coord, planet) == ChunkShell::Crust))
+        coldChunks.Put(c.coord, std::move(c.blocks), c.summary, c.lastVisible);
+
+    RemoveChunk(c.coord); // c is gone after this
+    buildStats.unloaded++;
 }
 
-void World::UpdateStreaming(glm::vec3 cameraPos, glm::vec3 cameraForward)
+// The wanted set is the render cube around the camera chunk plus the render
+// cube around the look-ahead chunk (where the camera's velocity takes it in
+// prefetchHorizon seconds), and the kept set the unload cube, so nothing
+// changes until one of the two crosses a chunk boundary. Then only the slabs
+// entering either cube are requested and only the slabs leaving the unload
+// cube are dropped.
+void World::UpdateStreaming(glm::vec3 cameraPos, glm::vec3 cameraForward, glm::vec3 cameraVelocity)
 {
+    double t0 = Now();
+    drawFrame++;
     ChunkCoord cc = CameraChunk(cameraPos);
 
+    ChunkCoord prev = streamCamChunk;
+    bool changedChunk = !(cc == prev);
     streamCamChunk = cc;
 
     float fLen = glm::length(cameraForward);
     streamCamForward = (fLen > 0.0001f) ? (cameraForward / fLen) : glm::vec3(0, 0, -1);
 
-    std::vector<Candidate> cand;
-    int side = 2 * renderDistance + 1;
-    cand.reserve(size_t(side) * side * side);
+    // Straight-line look-ahead, in chunks. Capped so the look-ahead cube
+    // stays inside the unload cube and prefetched chunks aren't dropped.
+    float maxLead = (float)std::max(0, unloadDistance - renderDistance);
+    glm::vec3 lead = glm::clamp(cameraVelocity * (prefetchHorizon / (float)CHUNK_SIZE),
+        glm::vec3(-maxLead), glm::vec3(maxLead));
+    ChunkCoord ahead = CameraChunk(cameraPos + lead * (float)CHUNK_SIZE);
+    ahead = {
+        std::clamp(ahead.x, cc.x - (int)maxLead, cc.x + (int)maxLead),
+        std::clamp(ahead.y, cc.y - (int)maxLead, cc.y + (int)maxLead),
+        std::clamp(ahead.z, cc.z - (int)maxLead, cc.z + (int)maxLead),
+    };
+
+    ChunkCoord prevAhead = streamAheadChunk;
+    bool changedAhead = !(ahead == prevAhead);
+    streamAheadChunk = ahead;
+
+    // queues only rescore when the camera changed chunk, turned, or the
+    // look-ahead moved
+    genQueue.SetView(cc, streamCamForward, streamFrontBias, lead);
+    meshQueue.SetView(cc, streamCamForward, streamFrontBias, lead);
+
+    if (!changedChunk && !changedAhead && !streamResync) {
+        buildStats.streamSec += Now() - t0;
+        return;
+    }
+
+    glm::ivec3 c = ToVec(cc), p = ToVec(prev);
+    glm::ivec3 a = ToVec(ahead), pa = ToVec(prevAhead);
+    glm::ivec3 r(renderDistance), u(unloadDistance);
+
+    auto inCube = [&](const ChunkCoord& q, const ChunkCoord& at) {
+        return std::max({ std::abs(q.x - at.x), std::abs(q.y - at.y), std::abs(q.z - at.z) }) <= renderDistance;
+    };
+
+    // Gen requests that left both cubes are cancelled along with their
+    // empty placeholder, so coming back requests them again.
+    genQueue.RemoveIf([&](const ChunkCoord& q) {
+        if (inCube(q, cc) || inCube(q, ahead)) return false;
+
+        const Chunk* chunk = FindChunk(q);
+        if (chunk && !chunk->generated && !chunk->genTicket)
+            RemoveChunk(q);
+        return true;
+    });
+
+    size_t unloadedBefore = buildStats.unloaded;
+    if (streamResync)
+    {
+        // distances changed (or first call): full pass
+        for (int dz = -renderDistance; dz <= renderDistance; dz++)
+            for (int dy = -renderDistance; dy <= renderDistance; dy++)
+                for (int dx = -renderDistance; dx <= renderDistance; dx++)
+                    RequestChunk({ cc.x + dx, cc.y + dy, cc.z + dz });
+        ForEachInBoxMinusBox(a - r, a + r, c - r, c + r,
+            [&](ChunkCoord want) { RequestChunk(want); });
+
+        // releasing the chunk being visited is safe, pool slots don't move
+        chunkPool.ForEach([&](Chunk& chunk)
+        {
+            const ChunkCoord& q = chunk.coord;
+            int distCheby = std::max({ std::abs(q.x - cc.x), std::abs(q.y - cc.y), std::abs(q.z - cc.z) });
+            if (distCheby > unloadDistance) UnloadChunk(chunk);
+        });
+        streamResync = false;
+    }
+    else
+    {
+        // entering the render cube: a hit if the look-ahead already got it
+        // generated and meshed, a miss if it still has to be built
+        ForEachInBoxMinusBox(c - r, c + r, p - r, p + r,
+            [&](ChunkCoord want) {
+                Chunk* got = RequestChunk(want);
+                if (!got || got->marker) return;
+                (got->generated && !got->dirty ? buildStats.prefetchHits : buildStats.prefetchMisses)++;
+            });
+
+        ForEachInBoxMinusBox(a - r, a + r, pa - r, pa + r,
+            [&](ChunkCoord want) {
+                if (inCube(want, cc) || FindChunk(want)) return;
+                Chunk* got = RequestChunk(want);
+                if (got && !got->marker) buildStats.prefetched++;
+            });
+
+        ForEachInBoxMinusBox(p - u, p + u, c - u, c + u,
+            [&](ChunkCoord gone) {
+                if (Chunk* chunk = FindChunk(gone)) UnloadChunk(*chunk);
+            });
+    }
+
+    if (buildStats.unloaded != unloadedBefore)
+        meshQueue.RemoveIf([&](const ChunkCoord& q) { return !chunkDir.Contains(q); });
+
+    buildStats.streamSec += Now() - t0;
+}
+
+
+size_t World::CountStreamTarget() const
+{
+    if (streamTarget.rd == renderDistance && streamTarget.at == streamCamChunk)
+        return streamTarget.count;
+
+    size_t n = 0;
     for (int dz = -renderDistance; dz <= renderDistance; dz++)
         for (int dy = -renderDistance; dy <= renderDistance; dy++)
             for (int dx = -renderDistance; dx <= renderDistance; dx++)
             {
-                ChunkCoord want{ cc.x + dx, cc.y + dy, cc.z + dz };
-                int dist2 = dx * dx + dy * dy + dz * dz;
-                float score = ScoreChunkFrontFirst(want, cc, streamCamForward, streamFrontBias);
-                cand.emplace_back(Candidate{ (ChunkCoord)want, (int)dist2, (float)score });
-                // or: cand.emplace_back(Candidate{ want, dist2, score });
-
+                ChunkCoord want{ streamCamChunk.x + dx, streamCamChunk.y + dy, streamCamChunk.z + dz };
+                if (ClassifyChunkShell(want, planet) != ChunkShell::Sky) n++;
             }
+    streamTarget = { streamCamChunk, renderDistance, n };
+    return n;
+}
 
-    std::sort(cand.begin(), cand.end(),
-        [](const Candidate& a, const Candidate& b) { return a.score < b.score; });
-    for (auto& want : cand)
-    {
-        if (chunks.find(want.cc) == chunks.end())
-        {
-            // insert the empty chunk now so we dont enqueue duplicates
-            Chunk c; c.coord = want.cc;
-            c.queuedGen = true;
-            chunks.emplace(want.cc, std::move(c));
-            genQueue.push_back(want.cc);
-        }
+void World::QueueMeshAfterGen(ChunkCoord cc, Chunk& c)
+{
+    QueueMesh(cc, c);
+
+    // neighbors
+    for (int fi = 0; fi < 6; fi++) {
+        Chunk* cn = Neighbor(c, fi);
+        if (cn && cn->generated)
+            QueueMesh(cn->coord, *cn);
     }
+}
 
-    // Unloa passs (done after, so we dont delete while iterating)
-    std::vector<ChunkCoord> toDelete;
-    for (auto& [coord, chunk] : chunks)
+// Worker-thread generation: integrate whatever finished since last tick, then
+// top the pool back up in priority order. Throughput is bounded by the
+// workers, not by how many ticks we get.
+void World::TickGenPool()
+{
+    if (!genPool) genPool = std::make_unique<ChunkGenPool>(genWorkers);
+
+    // 1) finished chunks -> live chunks
+    genDone.clear();
+    genPool->Drain(genDone);
+    for (auto& r : genDone)
     {
-        int ddx = coord.x - cc.x;
-        int ddy = coord.y - cc.y;
-        int ddz = coord.z - cc.z;
-        int distCheby = std::max<int>({ std::abs(ddx), std::abs(ddy), std::abs(ddz) });
+        // stale handle = unloaded meanwhile, even if the slot was reused
+        Chunk* pc = chunkPool.Get(r->handle);
+        if (!pc) continue;
 
-        if (distCheby > unloadDistance)
-        {
-            toDelete.push_back(coord);
+        Chunk& c = *pc;
+        if (c.genTicket != r->ticket) continue; // cancelled + re-requested meanwhile
 
+        c.blocks = std::move(r->blocks);
+        c.summary = r->summary;
+        c.genTicket.reset();
+        c.queuedGen = false;
+        c.dirty = true;
+        c.generated = true;
+        ApplyEdits(c);
+
+        if (r->fromDisk) {
+            buildStats.loadedFromDisk++;
+            buildStats.diskSec += r->sec;
+        } else {
+            if (saveGenerated) MarkUnsaved(c);
+            buildStats.generated++;
+            buildStats.genSec += r->sec;
         }
 
+        QueueMeshAfterGen(r->cc, c);
     }
+    genDone.clear();
 
-    for (auto& coord : toDelete)
+    // 2) keep the workers busy
+    size_t limit = (size_t)genPool->Workers() * (size_t)genInFlightPerWorker;
+    while (genPool->InFlight() < limit && !genQueue.Empty())
     {
-        //Free GPU buffers too
-        auto it = chunks.find(coord);
-        if (it != chunks.end())
-        {
-            Chunk& c = it->second;
-            c.opaque.Destroy();
-            c.water.Destroy();
+        ChunkCoord cc;
+        if (!genQueue.Pop(cc))
+            break;
 
-            chunks.erase(it);
-        }
+        ChunkHandle h = FindHandle(cc);
+        Chunk* c = chunkPool.Get(h);
+        if (!c) continue;
+
+        c->genTicket = genPool->Submit(cc, h, planet, regionStore.get());
     }
 }
 
-
-bool ChunkAllAir(const Chunk& c)
+void World::TickBuildQueues(double budgetUs, double lastFrameUs)
 {
-    for (Block b : c.blocks) if (b != Block::Air) return false;
-    return true;
-}
-
+    buildScheduler.Begin(budgetUs, lastFrameUs);
 
-void World::TickBuildQueues(int maxGenPerFrame, int maxMeshPerFrame)
-{
-    // 1) Generate blocks
-  
    // --- Debug: streaming stats + FPS (prints ~once per second) ---
-    static double statsT0 = glfwGetTime();
+    static double statsT0 = Now();
     static int frames = 0;
     frames++;
 
-    double now = glfwGetTime();
+    double now = Now();
     double dt = now - statsT0;
 
-    if (dt > 1.0)
+    if (streamLogging && dt > 1.0)
     {
         // Average FPS over the last dt seconds
         double fps = (dt > 0.0) ? (double(frames) / dt) : 0.0;
@@ -162,18 +352,19 @@ void World::TickBuildQueues(int maxGenPerFrame, int maxMeshPerFrame)
         frames = 0;
         statsT0 = now;
 
-        size_t loaded = chunks.size();
+        size_t loaded = chunkPool.Size();
         size_t generated = 0;
         size_t meshed = 0;
+        size_t blockBytes = 0;
 
-        for (auto& [coord, c] : chunks)
+        chunkPool.ForEach([&](const Chunk& c)
         {
             if (c.generated) generated++;
             if (c.generated && !c.dirty) meshed++;
-        }
+            blockBytes += c.blocks.MemoryBytes();
+        });
 
-        int side = 2 * renderDistance + 1;
-        size_t targetAtRest = (size_t)side * (size_t)side * (size_t)side;
+        size_t targetAtRest = CountStreamTarget();
 
         int fpsRounded = (int)(fps + 0.5); // nice clean integer fps
 
@@ -183,86 +374,160 @@ void World::TickBuildQueues(int maxGenPerFrame, int maxMeshPerFrame)
             << " (target~" << targetAtRest << ")"
             << " generated=" << generated
             << " meshed=" << meshed
-            << " genQ=" << genQueue.size()
-            << " meshQ=" << meshQueue.size()
+            << " blocks=" << (blockBytes >> 10) << "KiB"
+            << " genQ=" << genQueue.Size()
+            << " genInFlight=" << (genPool ? genPool->InFlight() : 0)
+            << " meshQ=" << meshQueue.Size()
+            << " budget=" << (int)buildScheduler.LastTick().budgetUs << "us"
+            << " drawn=" << drawCounts[(int)MeshPass::Opaque].drawn
+            << " culled=" << drawCounts[(int)MeshPass::Opaque].culled
             << " renderDistance=" << renderDistance
             << " unloadDistance=" << unloadDistance
             << "\n";
     }
 
 
-    for (int i = 0; i < maxGenPerFrame && !genQueue.empty(); i++)
+    // 1) Generate blocks
+    if (genWorkers > 0)
     {
-        ChunkCoord cc;
-        if (!PopBestChunk(genQueue, streamCamChunk, streamCamForward, streamFrontBias, cc))
-            break;
+        TickGenPool();
+    }
+    else
+    {
+        // inline gen and mesh share the budget by the work queued behind each
+        double genShare = meshWorkers > 0 ? buildScheduler.LastTick().budgetUs :
+            buildScheduler.Share(BuildScheduler::Gen, genQueue.Size(),
+                BuildScheduler::Mesh, meshQueue.Size());
 
-        auto it = chunks.find(cc);
-        if (it == chunks.end()) continue;
+        while (!genQueue.Empty() && buildScheduler.Admit(BuildScheduler::Gen, genShare))
+        {
+            ChunkCoord cc;
+            if (!genQueue.Pop(cc))
+                break;
 
-        Chunk& c = it->second;
-        c.queuedGen = false;
+            Chunk* pc = FindChunk(cc);
+            if (!pc) continue;
+
+            Chunk& c = *pc;
+            c.queuedGen = false;
+
+            double t0 = Now();
+            FillChunkBlocks(c);
+            QueueMeshAfterGen(cc, c);
+            buildScheduler.Record(BuildScheduler::Gen, (Now() - t0) * 1e6);
+        }
+    }
+
+    // 2) build meshes
+    if (meshWorkers > 0)
+        TickMeshPool();
+    else
+    {
+        while (!meshQueue.Empty() && buildScheduler.Admit(BuildScheduler::Mesh))
+        {
+            ChunkCoord cc;
+            if (!meshQueue.Pop(cc))
+                break;
 
-        static const ChunkCoord N6[6] = {
-    { 1,0,0}, {-1,0,0},
-    { 0,1,0}, { 0,-1,0},
-    { 0,0,1}, { 0,0,-1}
-        };
+            Chunk* pc = FindChunk(cc);
+            if (!pc) continue;
 
+            Chunk& c = *pc;
+            c.queuedMesh = false;
+            if (SkipFacelessMesh(c)) continue;
 
-        FillChunkBlocks(c);
-        if (!c.queuedMesh) {
-            c.queuedMesh = true;
-            meshQueue.push_back(cc);
+            double t0 = Now();
+            BuildChunkMesh(c);
+            buildScheduler.Record(BuildScheduler::Mesh, (Now() - t0) * 1e6);
         }
+    }
 
-        // neighbors
-        for (auto d : N6) {
-            ChunkCoord n{ cc.x + d.x, cc.y + d.y, cc.z + d.z };
-            auto itN = chunks.find(n);
-            if (itN != chunks.end() && itN->second.generated) {
-                Chunk& cn = itN->second;
-                if (cn.generated && !cn.queuedMesh) {
-                    cn.queuedMesh = true;
-                    meshQueue.push_back(n);
-                }
-            }
+    // 3) write-behind: generated chunks to the region store, edits to the journal
+    TickSaves();
+    FlushEditJournal();
+
+    if (buildScheduler.OverBudget()) buildStats.overBudget++;
+}
+
+// Encoding is all Save costs here; the I/O thread does the writing. Stops
+// early if that thread has a backlog, the rest waits for the next tick (or
+// goes with UnloadChunk).
+void World::TickSaves()
+{
+    if (!regionStore) return;
+
+    while (!saveQueue.empty() && buildScheduler.Admit(BuildScheduler::Save) &&
+        regionStore->Pending() < MAX_PENDING_SAVES)
+    {
+        ChunkCoord cc = saveQueue.front();
+        saveQueue.pop_front();
+
+        Chunk* c = FindChunk(cc);
+        if (!c || !c->unsaved) continue; // unloaded (saved then) or already saved
+
+        double t0 = Now();
+        regionStore->Save(cc, c->blocks, c->summary);
+        c->unsaved = false;
+        buildStats.saved++;
+        buildScheduler.Record(BuildScheduler::Save, (Now() - t0) * 1e6);
+    }
+}
+
+// Worker-thread meshing: results land in uploadQueue, and only the uploads
+// are budgeted per tick (MeshSink::Upload has to stay on this thread).
+void World::TickMeshPool()
+{
+    if (!meshPool) meshPool = std::make_unique<ChunkMeshPool>(meshWorkers);
+
+    // 1) finished meshes -> upload queue (drop anything already outdated)
+    meshDone.clear();
+    meshPool->Drain(meshDone);
+    for (auto& r : meshDone)
+    {
+        buildStats.meshSec += r->sec;
+
+        Chunk* c = FindChunk(r->cc);
+        if (!c || c->meshVersion != r->version) {
+            buildStats.meshStale++;
+            continue;
         }
+        uploadQueue.push_back(std::move(r));
     }
+    meshDone.clear();
 
-    bool doRender = false;
-    for (auto& cc : chunks)
+    // 2) bounded uploads
+    while (!uploadQueue.empty() && buildScheduler.Admit(BuildScheduler::Upload))
     {
-        if (!ChunkAllAir(cc.second))
-        {
-            doRender = true;
-            break;
+        std::unique_ptr<ChunkMeshPool::Result> r = std::move(uploadQueue.front());
+        uploadQueue.pop_front();
+
+        Chunk* c = FindChunk(r->cc);
+        if (!c || c->meshVersion != r->version) {
+            buildStats.meshStale++;
+            continue;
         }
+
+        double t0 = Now();
+        UploadChunkMesh(*c, r->mesh);
+        buildScheduler.Record(BuildScheduler::Upload, (Now() - t0) * 1e6);
     }
-    if (!doRender) return;
 
-    // 2) build meshes
-    for (int i = 0; i < maxMeshPerFrame && !meshQueue.empty(); i++)
+    // 3) keep the workers busy
+    size_t limit = (size_t)meshPool->Workers() * (size_t)meshInFlightPerWorker;
+    while (meshPool->InFlight() < limit && !meshQueue.Empty())
     {
         ChunkCoord cc;
-        if (!PopBestChunk(meshQueue, streamCamChunk, streamCamForward, streamFrontBias, cc))
+        if (!meshQueue.Pop(cc))
             break;
 
-        auto it = chunks.find(cc);
-        if (it == chunks.end()) continue;
+        Chunk* pc = FindChunk(cc);
+        if (!pc) continue;
 
-        Chunk& c = it->second;
+        Chunk& c = *pc;
         c.queuedMesh = false;
-        BuildChunkMesh(c);
-
-        static double t0 = glfwGetTime();
-        double t = glfwGetTime();
-        if (t - t0 > 1.0) {
-            t0 = t;
-         
-        }
-
-
+        if (!c.generated) continue;
+        if (SkipFacelessMesh(c)) continue;
 
+        meshPool->Submit(MakeMeshSnapshot(c), c.meshVersion);
     }
 }
@@ -1,9 +1,12 @@
-#version 330 core
-layout (location=0) in vec3 aPos;
-layout (location=1) in vec2 aLocalUV;   // 0..w/h in "block units"
-layout (location=2) in vec3 aNormal;
-layout (location=3) in float aLayer;
-layout (location=4) in vec2 aTile;      // (col,row) in the cube-net grid
+#version 430 core
+// Chunk quads, pulled from the world quad arena SSBO of PackedQuad
+// (src/mesh/PackedQuad.h). GpuMeshSink draws every chunk of a pass with one
+// glMultiDrawArraysIndirect; a chunk's command is first = offset * 6,
+// count = quads * 6, so gl_VertexID / 6 is the quad's index in the arena.
+
+layout(std430, binding = 0) readonly buffer Quads {
+    uvec2 quads[];
+};
 
 out vec2 LocalUV;
 flat out vec2 Tile;
@@ -13,11 +16,65 @@ out vec3 WorldPos;
 uniform mat4 view;
 uniform mat4 projection;
 
+// chunk min corner, world voxels; per instance, baseInstance picks the draw's
+layout(location = 0) in ivec3 aChunkOrigin;
+uniform vec3  uCameraPos;
+
+// same tables as PackedQuad.h / Mesher.h
+const int FACE_Q_MAP[24] = int[24](
+    0,1,2,3,  // +X
+    3,2,1,0,  // -X
+    1,2,3,0,  // +Y
+    0,3,2,1,  // -Y
+    1,2,3,0,  // +Z
+    0,3,2,1   // -Z
+);
+const int QUAD_TRI[6] = int[6](0, 1, 2, 0, 2, 3);
+const vec2 UV4[4] = vec2[4](vec2(0,0), vec2(0,1), vec2(1,1), vec2(1,0));
+const vec3 FACE_NORMAL[6] = vec3[6](
+    vec3( 1,0,0), vec3(-1,0,0),
+    vec3(0, 1,0), vec3(0,-1,0),
+    vec3(0,0, 1), vec3(0,0,-1)
+);
+
 void main() {
-    LocalUV = aLocalUV;
-    Tile = aTile;
-    Normal = aNormal;
-    TexLayer = aLayer;
-    WorldPos = aPos;
-    gl_Position = projection * view * vec4(aPos, 1.0);
-}
\ No newline at end of file
+    uvec2 q = quads[gl_VertexID / 6];
+    int ci = QUAD_TRI[gl_VertexID % 6];
+
+    ivec3 p0 = ivec3(q.x & 31u, (q.x >> 5) & 31u, (q.x >> 10) & 31u);
+    int w    = int((q.x >> 15) & 15u) + 1;
+    int h    = int((q.x >> 19) & 15u) + 1;
+    int face = int((q.x >> 23) & 7u);
+
+    int axis = face >> 1;
+    ivec3 du = ivec3(0), dv = ivec3(0);
+    du[(axis + 1) % 3] = w;
+    dv[(axis + 2) % 3] = h;
+
+    // canonical corners, then reorder to the FACES[face].c winding
+    ivec3 Q[4] = ivec3[4](p0, p0 + du, p0 + du + dv, p0 + dv);
+    ivec3 P0 = Q[FACE_Q_MAP[face * 4 + 0]];
+    ivec3 P1 = Q[FACE_Q_MAP[face * 4 + 1]];
+    ivec3 P2 = Q[FACE_Q_MAP[face * 4 + 2]];
+    ivec3 local = Q[FACE_Q_MAP[face * 4 + ci]];
+
+    // edge 0->1 is V direction, edge 1->2 is U direction
+    ivec3 e0 = abs(P1 - P0);
+    ivec3 e1 = abs(P2 - P1);
+    float vSpan = float(e0.x + e0.y + e0.z);
+    float uSpan = float(e1.x + e1.y + e1.z);
+
+    LocalUV = UV4[ci] * vec2(uSpan, vSpan);
+    Tile = vec2(float((q.y >> 8) & 3u), float((q.y >> 10) & 3u));
+    Normal = FACE_NORMAL[face];
+    TexLayer = float(q.y & 255u);
+
+    // Camera-relative position: the big terms cancel in integers before
+    // anything is converted to float.
+    ivec3 camCell = ivec3(floor(uCameraPos));
+    vec3 rel = vec3(aChunkOrigin - camCell + local) - (uCameraPos - vec3(camCell));
+
+    WorldPos = vec3(aChunkOrigin + local);
+    // view is a lookAt, so mat3(view) is its rotation without the translation
+    gl_Position = projection * mat4(mat3(view)) * vec4(rel, 1.0);
+}